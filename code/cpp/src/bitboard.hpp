@@ -0,0 +1,57 @@
+#pragma once
+
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+
+// Boards with more than 64 cells can use the bitboard move engine by building with "make BITBOARD_WORDS=2".
+#ifndef BITBOARD_WORDS
+# define BITBOARD_WORDS 1
+#endif
+
+
+static std::size_t constexpr bitboard_words = BITBOARD_WORDS;
+static std::size_t constexpr bitboard_word_bits = 64;
+
+
+// Bit "x + y * width" is set when that cell is taken up by a wall or a piece.
+struct Bitboard
+{
+	std::array<uint64_t, bitboard_words> words;
+
+	bool intersects(const Bitboard &other) const
+	{
+		uint64_t intersection = 0;
+
+		for (std::size_t word_index = 0; word_index < bitboard_words; ++word_index)
+		{
+			intersection |= words[word_index] & other.words[word_index];
+		}
+
+		return intersection != 0;
+	}
+
+	void toggle(const Bitboard &other)
+	{
+		for (std::size_t word_index = 0; word_index < bitboard_words; ++word_index)
+		{
+			words[word_index] ^= other.words[word_index];
+		}
+	}
+
+	void set(const int cell_index)
+	{
+		words[cell_index / bitboard_word_bits] |= uint64_t(1) << (cell_index % bitboard_word_bits);
+	}
+};
+
+struct BitboardMove
+{
+	// The cells that have to be empty for the move, which is the piece itself when the move would leave the board.
+	Bitboard collision;
+
+	// The emptied cells together with the collision cells, as both flip when the piece moves.
+	Bitboard toggled;
+};
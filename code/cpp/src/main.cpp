@@ -4,13 +4,37 @@
 
 int main(int argc, char *argv[])
 {
-	(void)argc;
-
 	std::filesystem::path exe_path = argv[0];
 
-	SlidingPuzzleSolver sliding_puzzle_solver(exe_path, "klotski");
+	Options options;
+
+	try
+	{
+		options = get_options(argc, argv);
+	}
+	catch (const std::invalid_argument &error)
+	{
+		std::cerr << error.what() << std::endl << std::endl << get_usage();
+		return EXIT_FAILURE;
+	}
+
+	if (options.show_help)
+	{
+		std::cout << get_usage();
+		return EXIT_SUCCESS;
+	}
+
+	try
+	{
+		SlidingPuzzleSolver sliding_puzzle_solver(exe_path, options);
 
-	sliding_puzzle_solver.solve();
+		sliding_puzzle_solver.solve();
+	}
+	catch (const std::exception &error)
+	{
+		std::cerr << error.what() << std::endl;
+		return EXIT_FAILURE;
+	}
 
 	return EXIT_SUCCESS;
 }
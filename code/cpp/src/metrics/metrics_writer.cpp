@@ -0,0 +1,130 @@
+#include "metrics_writer.hpp"
+
+#include "../sliding_puzzle_solver.hpp"
+
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+
+void MetricsWriter::open(void)
+{
+	const std::string &metrics_out_path = sps.options.metrics_out_path;
+
+	if (metrics_out_path.empty())
+	{
+		return;
+	}
+
+	stream.open(metrics_out_path);
+
+	if (!stream)
+	{
+		throw std::runtime_error("Couldn't open " + metrics_out_path + " for writing");
+	}
+
+	previous_interval_time = sps.start_time;
+}
+
+
+void MetricsWriter::write_interval(void)
+{
+	if (!stream.is_open())
+	{
+		return;
+	}
+
+	const std::chrono::steady_clock::time_point interval_time = std::chrono::steady_clock::now();
+	const ProgressCounters::Totals totals = sps.progress_counters.get_totals();
+
+	const std::chrono::duration<double> elapsed_time = interval_time - sps.start_time;
+	const std::chrono::duration<double> interval_duration = interval_time - previous_interval_time;
+
+	const double states_per_second = (totals.unique_state_count - previous_unique_state_count) / interval_duration.count();
+
+	previous_interval_time = interval_time;
+	previous_unique_state_count = totals.unique_state_count;
+
+	nlohmann::ordered_json record = {
+		{"type", "interval"},
+		{"elapsed_seconds", elapsed_time.count()},
+		{"unique_states", totals.unique_state_count},
+		{"states_per_second", states_per_second},
+		{"expanded_states", totals.expanded_state_count},
+		{"frontier_size", totals.frontier_size},
+		{"depth", totals.depth},
+		{"resident_bytes", get_resident_bytes()},
+		{"load_factor", nullptr}
+	};
+
+	if (totals.visited_state_set_capacity != 0)
+	{
+		record["load_factor"] = double(totals.visited_state_set_size) / totals.visited_state_set_capacity;
+	}
+
+	stream << record.dump() << std::endl;
+}
+
+
+void MetricsWriter::write_summary(const std::chrono::steady_clock::time_point end_time)
+{
+	if (!stream.is_open())
+	{
+		return;
+	}
+
+	const ProgressCounters::Totals totals = sps.progress_counters.get_totals();
+
+	const std::chrono::duration<double> wall_time = end_time - sps.start_time;
+
+	// Adds up the time every thread spent, in the program and in the kernel.
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	const double cpu_seconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+
+	const Options &options = sps.options;
+
+	nlohmann::ordered_json record = {
+		{"type", "summary"},
+		{"puzzle", options.puzzle_name},
+		{"search", options.search},
+		{"threads", options.thread_count},
+		{"path_length", nullptr},
+		{"unique_states", totals.unique_state_count},
+		{"expanded_states", totals.expanded_state_count},
+		{"generated_states", totals.generated_state_count},
+		{"tested_moves", totals.tested_move_count},
+		{"wall_seconds", wall_time.count()},
+		{"cpu_seconds", cpu_seconds},
+		{"peak_resident_bytes", uint64_t(usage.ru_maxrss) * 1024}
+	};
+
+	const bool searches_path = !options.enumerate && options.distance_database_out_path.empty();
+
+	// Stays null when no path was searched for or found, or when the search only finds its length.
+	// A starting state that is already a goal state has an empty path, which is still a path of length 0.
+	if (!sps.path.empty() || (searches_path && sps.is_goal(sps.get_starting_pieces())))
+	{
+		record["path_length"] = sps.path.size();
+	}
+
+	stream << record.dump() << std::endl;
+}
+
+
+uint64_t MetricsWriter::get_resident_bytes(void)
+{
+	// The second number is the number of pages in memory.
+	std::ifstream statm_stream("/proc/self/statm");
+
+	uint64_t size_pages;
+	uint64_t resident_pages;
+
+	if (!(statm_stream >> size_pages >> resident_pages))
+	{
+		return 0;
+	}
+
+	return resident_pages * sysconf(_SC_PAGESIZE);
+}
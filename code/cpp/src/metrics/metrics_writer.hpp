@@ -0,0 +1,37 @@
+#pragma once
+
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+
+
+class SlidingPuzzleSolver;
+
+/*
+Writes the progress of the search to --metrics-out as JSON lines, so it can be charted without scraping the terminal.
+The TimedPrinter writes an "interval" record every time it prints, and solve() writes a "summary" record at the end.
+Every record is flushed right away, so the file can be followed while the search runs.
+*/
+class MetricsWriter
+{
+public:
+	MetricsWriter(SlidingPuzzleSolver &sps_) : sps(sps_) {};
+
+	// Does nothing without --metrics-out.
+	void open(void);
+
+	void write_interval(void);
+	void write_summary(const std::chrono::steady_clock::time_point end_time);
+
+private:
+	// Zero if /proc/self/statm can't be read.
+	uint64_t get_resident_bytes(void);
+
+	SlidingPuzzleSolver &sps;
+
+	std::ofstream stream;
+
+	std::chrono::steady_clock::time_point previous_interval_time;
+	uint64_t previous_unique_state_count = 0;
+};
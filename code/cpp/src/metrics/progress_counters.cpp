@@ -0,0 +1,37 @@
+#include "progress_counters.hpp"
+
+
+ProgressCounters::ProgressCounters(const std::size_t thread_count)
+	: slot_count(thread_count), slots(new Slot[thread_count])
+{
+}
+
+
+ProgressCounters::Slot &ProgressCounters::get_slot(const std::size_t thread_index)
+{
+	return slots[thread_index];
+}
+
+
+ProgressCounters::Totals ProgressCounters::get_totals(void) const
+{
+	Totals totals = {};
+
+	for (std::size_t slot_index = 0; slot_index < slot_count; ++slot_index)
+	{
+		const Slot &slot = slots[slot_index];
+
+		totals.tested_move_count += slot.tested_move_count.load();
+		totals.generated_state_count += slot.generated_state_count.load();
+		totals.unique_state_count += slot.unique_state_count.load();
+		totals.expanded_state_count += slot.expanded_state_count.load();
+	}
+
+	totals.frontier_size = frontier_size.load();
+	totals.depth = depth.load();
+
+	totals.visited_state_set_size = visited_state_set_size.load();
+	totals.visited_state_set_capacity = visited_state_set_capacity.load();
+
+	return totals;
+}
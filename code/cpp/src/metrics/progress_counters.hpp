@@ -0,0 +1,104 @@
+#pragma once
+
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+
+/*
+A counter that only a single thread writes to, while any thread can read it.
+With only one writer there's nothing to lock, so it's bumped with a relaxed load and store
+instead of a locked read-modify-write, which costs the same as bumping a plain integer.
+*/
+class RelaxedCounter
+{
+public:
+	void operator+=(const uint64_t amount)
+	{
+		value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+
+	void operator++(int)
+	{
+		*this += 1;
+	}
+
+	void operator=(const uint64_t new_value)
+	{
+		value.store(new_value, std::memory_order_relaxed);
+	}
+
+	uint64_t load(void) const
+	{
+		return value.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<uint64_t> value = 0;
+};
+
+
+/*
+What the searches have done so far, for the TimedPrinter to report while they're still running.
+
+Every thread that expands states bumps the counters of its own Slot, which sits on its own cache line,
+so the threads never write to the same line as each other or as the reader.
+get_totals() adds the slots up without locking anything, so a total can lag behind by a few states.
+*/
+class ProgressCounters
+{
+public:
+	ProgressCounters(const std::size_t thread_count);
+
+	struct alignas(64) Slot
+	{
+		// Every direction of every piece that was checked for whether it can move.
+		RelaxedCounter tested_move_count;
+
+		// The states that the moves led to, whether they had been visited before or not.
+		RelaxedCounter generated_state_count;
+
+		// The generated states that hadn't been visited before, which is what is left after deduplicating them.
+		RelaxedCounter unique_state_count;
+
+		// The states whose moves have been tried, which is how the searches are compared.
+		RelaxedCounter expanded_state_count;
+	};
+
+	struct Totals
+	{
+		uint64_t tested_move_count;
+		uint64_t generated_state_count;
+		uint64_t unique_state_count;
+		uint64_t expanded_state_count;
+
+		uint64_t frontier_size;
+		uint64_t depth;
+
+		uint64_t visited_state_set_size;
+		uint64_t visited_state_set_capacity;
+	};
+
+	// The thread index is the one the search hands its threads, and the searches that only use one thread use 0.
+	Slot &get_slot(const std::size_t thread_index = 0);
+
+	Totals get_totals(void) const;
+
+	// The rest is only written by the thread that runs the search, and not by the threads it starts.
+
+	// The number of states that have been discovered but not expanded yet.
+	RelaxedCounter frontier_size;
+
+	// The path length the search has reached.
+	RelaxedCounter depth;
+
+	// The hash set of visited states, for its load factor, which stays zero for the searches that don't have a single one.
+	RelaxedCounter visited_state_set_size;
+	RelaxedCounter visited_state_set_capacity;
+
+private:
+	std::size_t slot_count;
+	std::unique_ptr<Slot[]> slots;
+};
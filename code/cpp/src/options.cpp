@@ -0,0 +1,217 @@
+#include "options.hpp"
+
+#include <algorithm>
+#include <vector>
+
+
+static const std::vector<std::string> search_names = {"bfs", "bidirectional", "astar", "idastar", "ranked", "external", "frontier"};
+static const std::vector<std::string> heuristic_names = {"manhattan", "relaxed", "pdb"};
+
+
+static std::string get_option_value(int argc, char *argv[], int &arg_index)
+{
+	const std::string option = argv[arg_index];
+
+	if (arg_index + 1 >= argc)
+	{
+		throw std::invalid_argument("The option " + option + " needs a value");
+	}
+
+	arg_index++;
+
+	return argv[arg_index];
+}
+
+
+int get_positive_int(const std::string &name, const std::string &value)
+{
+	std::size_t parsed_length = 0;
+	int parsed_value = 0;
+
+	try
+	{
+		parsed_value = std::stoi(value, &parsed_length);
+	}
+	catch (const std::exception &)
+	{
+		parsed_length = 0;
+	}
+
+	if (parsed_length != value.length() || parsed_value < 1)
+	{
+		throw std::invalid_argument(name + " needs a positive number, but got \"" + value + "\"");
+	}
+
+	return parsed_value;
+}
+
+
+static int get_positive_int_option_value(int argc, char *argv[], int &arg_index)
+{
+	const std::string option = argv[arg_index];
+
+	return get_positive_int("The option " + option, get_option_value(argc, argv, arg_index));
+}
+
+
+static std::string get_named_option_value(int argc, char *argv[], int &arg_index, const std::vector<std::string> &names)
+{
+	const std::string option = argv[arg_index];
+	const std::string value = get_option_value(argc, argv, arg_index);
+
+	if (std::find(names.cbegin(), names.cend(), value) == names.cend())
+	{
+		throw std::invalid_argument("The option " + option + " doesn't know \"" + value + "\"");
+	}
+
+	return value;
+}
+
+
+Options get_options(int argc, char *argv[])
+{
+	Options options;
+
+	for (int arg_index = 1; arg_index < argc; ++arg_index)
+	{
+		const std::string arg = argv[arg_index];
+
+		if (arg == "--puzzle")
+		{
+			options.puzzle_name = get_option_value(argc, argv, arg_index);
+		}
+		else if (arg == "--search")
+		{
+			options.search = get_named_option_value(argc, argv, arg_index, search_names);
+		}
+		else if (arg == "--heuristic")
+		{
+			options.heuristic = get_named_option_value(argc, argv, arg_index, heuristic_names);
+		}
+		else if (arg == "--pdb")
+		{
+			options.pattern_database_paths.push_back(get_option_value(argc, argv, arg_index));
+			options.heuristic = "pdb";
+		}
+		else if (arg == "--transposition-table-mb")
+		{
+			options.transposition_table_megabytes = get_positive_int_option_value(argc, argv, arg_index);
+		}
+		else if (arg == "--scratch-dir")
+		{
+			options.scratch_directory_path = get_option_value(argc, argv, arg_index);
+		}
+		else if (arg == "--buffer-mb")
+		{
+			options.buffer_megabytes = get_positive_int_option_value(argc, argv, arg_index);
+		}
+		else if (arg == "--divide-and-conquer")
+		{
+			options.divide_and_conquer = true;
+		}
+		else if (arg == "--checkpoint")
+		{
+			options.checkpoint_path = get_option_value(argc, argv, arg_index);
+		}
+		else if (arg == "--checkpoint-seconds")
+		{
+			options.checkpoint_seconds = get_positive_int_option_value(argc, argv, arg_index);
+		}
+		else if (arg == "--checkpoint-layers")
+		{
+			options.checkpoint_layers = get_positive_int_option_value(argc, argv, arg_index);
+		}
+		else if (arg == "--resume")
+		{
+			options.resume = true;
+		}
+		else if (arg == "--threads")
+		{
+			options.thread_count = get_positive_int_option_value(argc, argv, arg_index);
+		}
+		else if (arg == "--enumerate")
+		{
+			options.enumerate = true;
+		}
+		else if (arg == "--stats-out")
+		{
+			options.stats_out_path = get_option_value(argc, argv, arg_index);
+		}
+		else if (arg == "--metrics-out")
+		{
+			options.metrics_out_path = get_option_value(argc, argv, arg_index);
+		}
+		else if (arg == "--distance-db-out")
+		{
+			options.distance_database_out_path = get_option_value(argc, argv, arg_index);
+		}
+		else if (arg == "--distance-db")
+		{
+			options.distance_database_path = get_option_value(argc, argv, arg_index);
+		}
+		else if (arg == "--moves")
+		{
+			options.moves = get_option_value(argc, argv, arg_index);
+		}
+		else if (arg == "--help")
+		{
+			options.show_help = true;
+		}
+		else
+		{
+			throw std::invalid_argument("Unknown argument \"" + arg + "\"");
+		}
+	}
+
+	if (!options.stats_out_path.empty() && !options.enumerate)
+	{
+		throw std::invalid_argument("--stats-out writes what --enumerate counts, so it needs --enumerate");
+	}
+
+	return options;
+}
+
+
+std::string get_usage(void)
+{
+	return
+		"Usage: puzzle [options]\n"
+		"  --puzzle <name>     Solves puzzles/<name>.jsonc, defaulting to klotski\n"
+		"  --search <name>     bfs (default), bidirectional, which also searches back from every goal state,\n"
+		"                      astar, which expands the states that look closest to the goal first,\n"
+		"                      idastar, which does depth-first searches with a growing bound instead and barely uses memory,\n"
+		"                      ranked, which numbers every placement of the pieces and keeps a bit per placement instead of a hash set,\n"
+		"                      external, which keeps every layer in a sorted file in --scratch-dir instead,\n"
+		"                      or frontier, which only keeps the last three layers and finds the path length\n"
+		"  --heuristic <name>  How astar and idastar estimate the distance to the goal: relaxed (default) lets every ending piece\n"
+		"                      move around the walls on its own, manhattan ignores the walls as well,\n"
+		"                      and pdb sums the pattern databases given with --pdb\n"
+		"  --pdb <file>        Loads a pattern database made by pdb_generator, and can be given once per pattern\n"
+		"  --transposition-table-mb <n>\n"
+		"                      The size of the table idastar remembers states in, defaulting to 256\n"
+		"  --scratch-dir <dir>\n"
+		"                      Where external keeps its files, and goes on from the last complete layer in them\n"
+		"  --buffer-mb <n>     The size of the buffer external sorts new states in before writing them, defaulting to 256\n"
+		"  --divide-and-conquer\n"
+		"                      Makes frontier also find the path, by searching for the states halfway along it again and again\n"
+		"  --checkpoint <file>\n"
+		"                      Makes the bfs write its progress to a file every so often\n"
+		"  --checkpoint-seconds <n>\n"
+		"                      How many seconds go by between checkpoints, defaulting to 600\n"
+		"  --checkpoint-layers <n>\n"
+		"                      Also writes a checkpoint whenever the path length has grown by n since the last one\n"
+		"  --resume            Makes the bfs go on from the --checkpoint file if it exists\n"
+		"  --threads <n>       Searches every BFS layer with n threads\n"
+		"  --enumerate         Visits every reachable state instead, and prints the number of states, goal states,\n"
+		"                      average branching factor and frontier size of every depth,\n"
+		"                      which --search ranked does with two bits per placement of the pieces\n"
+		"  --stats-out <file>  Writes the --enumerate statistics to a file instead, as JSON if it ends in .json and CSV otherwise\n"
+		"  --metrics-out <file>\n"
+		"                      Writes the progress every second and a summary at the end to a file, as JSON lines\n"
+		"  --distance-db-out <file>\n"
+		"                      Writes the distance to the goal of every state that can reach it to a file instead\n"
+		"  --distance-db <file>\n"
+		"                      Prints the distance to the goal, the best next move and a shortest path from that file\n"
+		"  --moves <moves>     Makes these moves, written like the printed path, before --distance-db answers\n"
+		"  --help              Prints this\n";
+}
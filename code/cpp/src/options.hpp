@@ -0,0 +1,70 @@
+#pragma once
+
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+
+struct Options
+{
+	std::string puzzle_name = "klotski";
+
+	// "bfs", "bidirectional", "astar", "idastar", "ranked", "external" or "frontier".
+	std::string search = "bfs";
+
+	// "relaxed", "manhattan" or "pdb", only used by "astar" and "idastar".
+	std::string heuristic = "relaxed";
+
+	// Every "--pdb <file>" adds one, and also switches the heuristic to "pdb".
+	std::vector<std::string> pattern_database_paths;
+
+	// The size of the transposition table of "idastar".
+	int transposition_table_megabytes = 256;
+
+	// Where "external" keeps its layer files, and the size of the buffer it sorts new states in.
+	std::string scratch_directory_path;
+	int buffer_megabytes = 256;
+
+	// Makes "frontier" rebuild the path, instead of only finding its length.
+	bool divide_and_conquer = false;
+
+	// Where the single-threaded BFS writes its checkpoints, every so many seconds,
+	// or every so many path lengths if checkpoint_layers isn't zero.
+	std::string checkpoint_path;
+	int checkpoint_seconds = 600;
+	int checkpoint_layers = 0;
+
+	// Goes on from the checkpoint, if it exists.
+	bool resume = false;
+
+	// A single thread runs the plain BFS, more threads run the level-synchronous ParallelBfs.
+	int thread_count = 1;
+
+	// Visits every reachable state instead of searching for the goal, and writes statistics about every depth.
+	bool enumerate = false;
+
+	// Where --enumerate writes its statistics, as JSON if this ends in ".json" and as CSV otherwise.
+	std::string stats_out_path;
+
+	// Where the progress of the search is written as JSON lines, every second and once more at the end.
+	std::string metrics_out_path;
+
+	// Writes the distance to the goal of every state that can reach it to this file, instead of searching.
+	std::string distance_database_out_path;
+
+	// Answers how far the starting state is from the goal after the moves, and how to get there, from this file.
+	std::string distance_database_path;
+	std::string moves;
+
+	bool show_help = false;
+};
+
+
+// Throws std::invalid_argument for arguments it doesn't understand.
+Options get_options(int argc, char *argv[]);
+
+std::string get_usage(void);
+
+// Also used by the tools, so a bad number says which argument it was given to. Throws std::invalid_argument.
+int get_positive_int(const std::string &name, const std::string &value);
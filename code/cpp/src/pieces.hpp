@@ -5,6 +5,10 @@ struct Offset
 {
 	int x;
 	int y;
+	bool operator==(const Offset &other) const
+	{
+		return x == other.x && y == other.y;
+	}
 };
 
 struct Pos
@@ -21,12 +25,20 @@ struct Size
 {
 	int width;
 	int height;
+	bool operator==(const Size &other) const
+	{
+		return width == other.width && height == other.height;
+	}
 };
 
 struct Rect
 {
 	Offset offset;
 	Size size;
+	bool operator==(const Rect &other) const
+	{
+		return offset == other.offset && size == other.size;
+	}
 };
 
 // TODO: Is it cleaner to replace Pos with Piece in here?
@@ -55,27 +67,18 @@ struct Piece
 	{
 		return top_left == other.top_left;
 	}
-	struct HashFunction {
-		// Hashing logic stolen from here: https://stackoverflow.com/a/27216842
-		size_t operator() (const pieces_t &pieces) const
-		{
-			std::size_t seed = pieces.size();
-
-			for (std::size_t piece_index = 0; piece_index != pieces.size(); ++piece_index)
-			{
-				const Piece &piece = pieces[piece_index];
-				const Pos &piece_top_left = piece.top_left;
-				const int x = piece_top_left.x;
-				const int y = piece_top_left.y;
-
-				// TODO: Profile whether calculating and storing width instead is faster.
-				// const int piece_index = x + y * width;
+};
 
-				seed ^= x + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-				seed ^= y + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-			}
+// Every discovered state remembers which move led to it, so the path can be walked back from the goal.
+struct StateRecord
+{
+	uint32_t parent_index;
+	uint8_t piece_index;
+	uint8_t direction;
+};
 
-			return seed;
-		}
-	};
+struct QueuedState
+{
+	state_key_t state_key;
+	uint32_t state_index;
 };
@@ -3,27 +3,41 @@
 #include "../sliding_puzzle_solver.hpp"
 
 
-void TimedPrinter::timed_print(const pieces_queue_t &pieces_queue, const path_queue_t &path_queue)
+void TimedPrinter::timed_print(void)
 {
 	std::cout << std::endl;
 
 	while (!sps.finished)
 	{
 		std::this_thread::sleep_for(std::chrono::seconds(1));
-		timed_print_core(pieces_queue, path_queue);
+		timed_print_core();
+
+		sps.metrics_writer.write_interval();
+	}
+
+	KiloFormatter kf;
+
+	std::cout << std::endl << std::endl << "Expanded states: " << kf.format(sps.progress_counters.get_totals().expanded_state_count) << std::endl << std::endl;
+
+	// These don't look for a path, and print what they found themselves.
+	if (sps.options.enumerate || !sps.options.distance_database_out_path.empty())
+	{
+		return;
 	}
 
-	std::cout << std::endl << std::endl << "Path:" << std::endl << get_path_string(path_queue.front()) << std::endl << std::endl;
+	std::cout << "Path:" << std::endl << get_path_string(sps.path) << std::endl << std::endl;
 }
 
 
-void TimedPrinter::timed_print_core(const pieces_queue_t &pieces_queue, const path_queue_t &path_queue)
+void TimedPrinter::timed_print_core(void)
 {
 	// TODO: Store elapsed_time in something more appropriate than int.
 	const int elapsed_time = get_elapsed_seconds().count();
 
-	const int states_count_diff = sps.state_count - sps.prev_state_count;
-	sps.prev_state_count = sps.state_count;
+	const ProgressCounters::Totals totals = sps.progress_counters.get_totals();
+
+	const uint64_t unique_state_count_diff = totals.unique_state_count - previous_unique_state_count;
+	previous_unique_state_count = totals.unique_state_count;
 
 	std::cout << "\33[2K\r"; // Clears the line and goes back to the left.
 
@@ -31,14 +45,11 @@ void TimedPrinter::timed_print_core(const pieces_queue_t &pieces_queue, const pa
 
 	KiloFormatter kf;
 
-	if (path_queue.size() > 0)
-	{
-		std::cout << ", Path length: " << kf.format(path_queue.front().size());
-	}
+	std::cout << ", Path length: " << kf.format(totals.depth);
 
-	std::cout << ", Unique states: " << kf.format(sps.state_count) << " (+" << kf.format(states_count_diff) << "/s)";
+	std::cout << ", Unique states: " << kf.format(totals.unique_state_count) << " (+" << kf.format(unique_state_count_diff) << "/s)";
 
-	std::cout << ", Queue length: " << kf.format(pieces_queue.size());
+	std::cout << ", Queue length: " << kf.format(totals.frontier_size);
 
 	std::cout << std::flush;
 }
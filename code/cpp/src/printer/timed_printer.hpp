@@ -6,6 +6,7 @@
 
 #include <chrono>
 #include <iostream>
+#include <cstdint>
 
 
 class SlidingPuzzleSolver;
@@ -14,12 +15,14 @@ class TimedPrinter
 {
 public:
 	TimedPrinter(SlidingPuzzleSolver &sps_) : sps(sps_) {};
-	void timed_print(const pieces_queue_t &pieces_queue, const path_queue_t &path_queue);
+	void timed_print(void);
 
 private:
-	void timed_print_core(const pieces_queue_t &pieces_queue, const path_queue_t &path_queue);
+	void timed_print_core(void);
 	std::chrono::duration<double> get_elapsed_seconds(void);
 	std::string get_path_string(const path_t &path);
 
-	const SlidingPuzzleSolver &sps;
+	SlidingPuzzleSolver &sps;
+
+	uint64_t previous_unique_state_count = 0;
 };
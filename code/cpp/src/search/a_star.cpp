@@ -0,0 +1,123 @@
+#include "a_star.hpp"
+
+#include "../sliding_puzzle_solver.hpp"
+
+
+void AStar::solve(void)
+{
+	goal_distance_heuristic.initialize();
+
+	pieces_t pieces = sps.get_starting_pieces();
+
+	const int goal_distance = goal_distance_heuristic.get_goal_distance(pieces);
+
+	if (goal_distance == GoalDistanceHeuristic::unreachable)
+	{
+		return;
+	}
+
+	const state_key_t starting_state_key = sps.get_state_key(pieces);
+
+	// The starting state is its own parent, just like in the BFS.
+	state_indices.emplace(sps.get_visited_state_key(starting_state_key), 0);
+	state_records.push_back({0, 0, 0});
+	path_lengths.push_back(0);
+	is_expanded.push_back(false);
+
+	open_states.push({goal_distance, 0, starting_state_key, 0});
+
+	board_t board;
+
+	ProgressCounters &progress_counters = sps.progress_counters;
+	ProgressCounters::Slot &progress = progress_counters.get_slot();
+
+	while (!open_states.empty())
+	{
+		progress_counters.frontier_size = open_states.size();
+
+		const OpenState open_state = open_states.top();
+		open_states.pop();
+
+		if (is_expanded[open_state.state_index] || open_state.path_length != path_lengths[open_state.state_index])
+		{
+			continue;
+		}
+
+		// The estimates of consistent heuristics never go down, so this is how long the path will be at least.
+		progress_counters.depth = open_state.estimated_path_length;
+
+		sps.set_pieces_from_state_key(pieces, open_state.state_key);
+
+		if (sps.is_goal(pieces))
+		{
+			progress_counters.depth = open_state.path_length;
+			sps.path = sps.get_path(state_records, open_state.state_index);
+			return;
+		}
+
+		is_expanded[open_state.state_index] = true;
+
+		sps.set_board_from_pieces(board, pieces);
+
+		open_valid_moves(pieces, board, open_state);
+
+		progress.tested_move_count += sps.pieces_count * sps.direction_count;
+		progress.expanded_state_count++;
+	}
+}
+
+
+void AStar::open_valid_moves(pieces_t &pieces, board_t &board, const OpenState &open_state)
+{
+	const int path_length = open_state.path_length + 1;
+
+	ProgressCounters::Slot &progress = sps.progress_counters.get_slot();
+
+	for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+	{
+		Pos &piece_top_left = pieces[piece_index].top_left;
+
+		for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+		{
+			if (sps.cant_move(piece_top_left, piece_index, direction, board))
+			{
+				continue;
+			}
+
+			sps.move(piece_top_left, piece_index, direction, board);
+
+			progress.generated_state_count++;
+
+			const int goal_distance = goal_distance_heuristic.get_goal_distance(pieces);
+
+			if (goal_distance != GoalDistanceHeuristic::unreachable)
+			{
+				const state_key_t state_key = sps.get_state_key(pieces);
+				const StateRecord state_record = {open_state.state_index, static_cast<uint8_t>(piece_index), static_cast<uint8_t>(direction)};
+
+				const auto [state_iterator, is_new] = state_indices.emplace(sps.get_visited_state_key(state_key), state_records.size());
+				const uint32_t state_index = state_iterator->second;
+
+				if (is_new)
+				{
+					state_records.push_back(state_record);
+					path_lengths.push_back(path_length);
+					is_expanded.push_back(false);
+
+					open_states.push({path_length + goal_distance, path_length, state_key, state_index});
+
+					progress.unique_state_count++;
+				}
+				else if (!is_expanded[state_index] && path_length < path_lengths[state_index])
+				{
+					state_records[state_index] = state_record;
+					path_lengths[state_index] = path_length;
+
+					open_states.push({path_length + goal_distance, path_length, state_key, state_index});
+				}
+			}
+
+			sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), board);
+		}
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+#include "../pieces.hpp"
+#include "goal_distance_heuristic.hpp"
+
+
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+
+class SlidingPuzzleSolver;
+
+/*
+Always expands the open state with the lowest path length plus estimated goal distance,
+preferring the state that is furthest along when there's a tie.
+The estimate never overshoots, so the first goal state that gets expanded is at the end of a shortest path.
+
+A state that is reached by a shorter path before it has been expanded is queued again,
+and the stale queued copy is skipped once it comes out of the queue.
+*/
+class AStar
+{
+public:
+	AStar(SlidingPuzzleSolver &sps_) : sps(sps_), goal_distance_heuristic(sps_) {};
+	void solve(void);
+
+private:
+	struct OpenState
+	{
+		int estimated_path_length;
+		int path_length;
+		state_key_t state_key;
+		uint32_t state_index;
+	};
+
+	struct OpenStateComparator
+	{
+		// std::priority_queue puts the greatest element on top, so this says which state should come out later.
+		bool operator()(const OpenState &a, const OpenState &b) const
+		{
+			if (a.estimated_path_length != b.estimated_path_length)
+			{
+				return a.estimated_path_length > b.estimated_path_length;
+			}
+
+			return a.path_length < b.path_length;
+		}
+	};
+
+	void open_valid_moves(pieces_t &pieces, board_t &board, const OpenState &open_state);
+
+	SlidingPuzzleSolver &sps;
+
+	GoalDistanceHeuristic goal_distance_heuristic;
+
+	// Maps visited state keys to state indices.
+	std::unordered_map<state_key_t, uint32_t, StateKey::HashFunction> state_indices;
+
+	// Indexed by state index.
+	state_records_t state_records;
+	std::vector<int> path_lengths;
+	std::vector<bool> is_expanded;
+
+	std::priority_queue<OpenState, std::vector<OpenState>, OpenStateComparator> open_states;
+};
@@ -0,0 +1,302 @@
+#include "bfs_checkpoint.hpp"
+
+#include "../sliding_puzzle_solver.hpp"
+
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+// std::queue keeps its container protected, but the checkpoint has to read it without copying it.
+struct PiecesQueueAccess : pieces_queue_t
+{
+	static const pieces_queue_t::container_type &get_container(const pieces_queue_t &pieces_queue)
+	{
+		return pieces_queue.*&PiecesQueueAccess::c;
+	}
+};
+
+
+/*
+Buffers the writes to a file on the stack.
+The forked child only has the thread that forked, so it can't allocate or lock anything
+that another thread of the parent could have been holding at that moment.
+*/
+struct SnapshotWriter
+{
+	SnapshotWriter(const char *path)
+		: file_descriptor(open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)), failed(file_descriptor == -1)
+	{
+	}
+
+	void write(const void *data, std::size_t size)
+	{
+		const char *bytes = static_cast<const char *>(data);
+
+		while (size > 0 && !failed)
+		{
+			const std::size_t copied_size = std::min(size, sizeof(buffer) - buffered_size);
+
+			std::memcpy(buffer + buffered_size, bytes, copied_size);
+			buffered_size += copied_size;
+			bytes += copied_size;
+			size -= copied_size;
+
+			if (buffered_size == sizeof(buffer))
+			{
+				flush();
+			}
+		}
+	}
+
+	// Returns whether everything was written.
+	bool close(void)
+	{
+		flush();
+
+		return ::close(file_descriptor) == 0 && !failed;
+	}
+
+private:
+	void flush(void)
+	{
+		for (std::size_t written_size = 0; written_size < buffered_size && !failed; )
+		{
+			const ssize_t result = ::write(file_descriptor, buffer + written_size, buffered_size - written_size);
+
+			failed = result <= 0;
+			written_size += result;
+		}
+
+		buffered_size = 0;
+	}
+
+	int file_descriptor;
+	bool failed;
+
+	char buffer[1 << 16];
+	std::size_t buffered_size = 0;
+};
+
+
+template <typename States>
+bool BfsCheckpoint::load(States &states, state_records_t &state_records, pieces_queue_t &pieces_queue, uint32_t &next_path_length_state_index)
+{
+	const std::string &checkpoint_path = sps.options.checkpoint_path;
+
+	std::ifstream stream(checkpoint_path, std::ios::binary);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	Header header;
+	stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+	check_header(header);
+
+	states.reserve(header.visited_state_count);
+
+	for (uint64_t state_index = 0; state_index < header.visited_state_count; ++state_index)
+	{
+		state_key_t state_key;
+		stream.read(reinterpret_cast<char *>(&state_key), sizeof(state_key));
+		states.insert(state_key);
+	}
+
+	state_records.resize(header.state_record_count);
+	stream.read(reinterpret_cast<char *>(state_records.data()), state_records.size() * sizeof(StateRecord));
+
+	for (uint64_t queue_index = 0; queue_index < header.queued_state_count; ++queue_index)
+	{
+		QueuedState queued_state;
+		stream.read(reinterpret_cast<char *>(&queued_state), sizeof(queued_state));
+		pieces_queue.push(queued_state);
+	}
+
+	if (!stream)
+	{
+		throw std::runtime_error("The checkpoint " + checkpoint_path + " is cut short");
+	}
+
+	ProgressCounters::Slot &progress = sps.progress_counters.get_slot();
+
+	sps.progress_counters.depth = header.path_length;
+	next_path_length_state_index = header.next_path_length_state_index;
+
+	progress.expanded_state_count = header.expanded_state_count;
+
+	// The starting state doesn't count as a discovered state.
+	progress.unique_state_count = state_records.size() - 1;
+
+	return true;
+}
+
+
+template <typename States>
+void BfsCheckpoint::update(const States &states, const state_records_t &state_records, const pieces_queue_t &pieces_queue, const uint32_t next_path_length_state_index)
+{
+	if (sps.progress_counters.get_slot().expanded_state_count.load() % expanded_states_per_clock_check != 0 || !is_time_for_checkpoint() || !reap_writer_process(false))
+	{
+		return;
+	}
+
+	const Header header = get_header(states.size(), state_records.size(), pieces_queue.size(), next_path_length_state_index);
+
+	const std::string checkpoint_path = sps.options.checkpoint_path;
+	const std::string temporary_checkpoint_path = checkpoint_path + ".tmp";
+
+	last_checkpoint_time = std::chrono::steady_clock::now();
+	last_checkpoint_path_length = sps.progress_counters.depth.load();
+
+	const pid_t process_id = fork();
+
+	if (process_id == -1)
+	{
+		throw std::runtime_error("Couldn't fork a process to write the checkpoint");
+	}
+
+	if (process_id != 0)
+	{
+		writer_process_id = process_id;
+		return;
+	}
+
+	SnapshotWriter writer(temporary_checkpoint_path.c_str());
+
+	writer.write(&header, sizeof(header));
+
+	const auto write_state_key = [&writer](const state_key_t &state_key)
+	{
+		writer.write(&state_key, sizeof(state_key));
+	};
+
+#ifdef UNORDERED_STATE_SET
+	std::for_each(states.begin(), states.end(), write_state_key);
+#else
+	states.for_each(write_state_key);
+#endif
+
+	writer.write(state_records.data(), state_records.size() * sizeof(StateRecord));
+
+	for (const auto &queued_state : PiecesQueueAccess::get_container(pieces_queue))
+	{
+		writer.write(&queued_state, sizeof(queued_state));
+	}
+
+	const bool is_written = writer.close() && std::rename(temporary_checkpoint_path.c_str(), checkpoint_path.c_str()) == 0;
+
+	// Skips the destructors and exit handlers, which belong to the parent.
+	_exit(is_written ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+template bool BfsCheckpoint::load<states_t>(states_t &states, state_records_t &state_records, pieces_queue_t &pieces_queue, uint32_t &next_path_length_state_index);
+template void BfsCheckpoint::update<states_t>(const states_t &states, const state_records_t &state_records, const pieces_queue_t &pieces_queue, const uint32_t next_path_length_state_index);
+
+
+void BfsCheckpoint::finish(void)
+{
+	reap_writer_process(true);
+}
+
+
+bool BfsCheckpoint::is_time_for_checkpoint(void)
+{
+	if (!is_started)
+	{
+		is_started = true;
+		last_checkpoint_time = std::chrono::steady_clock::now();
+		last_checkpoint_path_length = sps.progress_counters.depth.load();
+
+		return false;
+	}
+
+	const Options &options = sps.options;
+
+	const int path_length = sps.progress_counters.depth.load();
+
+	if (options.checkpoint_layers > 0 && path_length - last_checkpoint_path_length >= options.checkpoint_layers)
+	{
+		return true;
+	}
+
+	return std::chrono::steady_clock::now() - last_checkpoint_time >= std::chrono::seconds(options.checkpoint_seconds);
+}
+
+
+BfsCheckpoint::Header BfsCheckpoint::get_header(const std::size_t visited_state_count, const std::size_t state_record_count, const std::size_t queued_state_count, const uint32_t next_path_length_state_index)
+{
+	Header header = {};
+
+	std::memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.state_key_words = state_key_words;
+	header.puzzle_fingerprint = sps.get_puzzle_fingerprint();
+	header.starting_state_key = sps.get_state_key(sps.get_starting_pieces());
+
+	header.path_length = sps.progress_counters.depth.load();
+	header.next_path_length_state_index = next_path_length_state_index;
+	header.expanded_state_count = sps.progress_counters.get_slot().expanded_state_count.load();
+
+	header.visited_state_count = visited_state_count;
+	header.state_record_count = state_record_count;
+	header.queued_state_count = queued_state_count;
+
+	return header;
+}
+
+
+void BfsCheckpoint::check_header(const Header &header)
+{
+	const std::string &checkpoint_path = sps.options.checkpoint_path;
+
+	if (std::memcmp(header.magic, magic, sizeof(magic)) != 0)
+	{
+		throw std::runtime_error(checkpoint_path + " isn't a checkpoint");
+	}
+
+	if (header.version != version)
+	{
+		throw std::runtime_error("The checkpoint " + checkpoint_path + " has version " + std::to_string(header.version) + ", but only version " + std::to_string(version) + " can be resumed");
+	}
+
+	if (header.state_key_words != state_key_words || header.puzzle_fingerprint != sps.get_puzzle_fingerprint())
+	{
+		throw std::runtime_error("The checkpoint " + checkpoint_path + " belongs to another puzzle or build");
+	}
+
+	if (header.starting_state_key != sps.get_state_key(sps.get_starting_pieces()))
+	{
+		throw std::runtime_error("The checkpoint " + checkpoint_path + " starts from other starting pieces");
+	}
+}
+
+
+bool BfsCheckpoint::reap_writer_process(const bool wait)
+{
+	if (writer_process_id == -1)
+	{
+		return true;
+	}
+
+	int status;
+	const pid_t result = waitpid(writer_process_id, &status, wait ? 0 : WNOHANG);
+
+	if (result == 0)
+	{
+		return false;
+	}
+
+	writer_process_id = -1;
+
+	if (result == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+	{
+		std::cerr << std::endl << "Couldn't write the checkpoint " << sps.options.checkpoint_path << std::endl;
+	}
+
+	return true;
+}
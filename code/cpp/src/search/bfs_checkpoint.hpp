@@ -0,0 +1,79 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+#include "../pieces.hpp"
+
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+
+class SlidingPuzzleSolver;
+
+/*
+Writes the visited states, the queue and the state records of the single-threaded BFS to --checkpoint every so often,
+so --resume can go on from there and still find the same shortest path.
+
+The BFS only stops for as long as it takes to fork the process.
+The child process writes the file from its copy-on-write snapshot of the memory, while the BFS goes on in the parent.
+It writes to a temporary file that only replaces the old checkpoint once it's complete.
+*/
+class BfsCheckpoint
+{
+public:
+	BfsCheckpoint(SlidingPuzzleSolver &sps_) : sps(sps_) {};
+
+	// Restores everything from the checkpoint file, and returns false if there isn't one.
+	template <typename States>
+	bool load(States &states, state_records_t &state_records, pieces_queue_t &pieces_queue, uint32_t &next_path_length_state_index);
+
+	// Called by the BFS after every expanded state, which starts writing a checkpoint once it's time for one.
+	template <typename States>
+	void update(const States &states, const state_records_t &state_records, const pieces_queue_t &pieces_queue, const uint32_t next_path_length_state_index);
+
+	// Waits for the checkpoint that is being written, if any.
+	void finish(void);
+
+private:
+	static std::size_t constexpr expanded_states_per_clock_check = 4096;
+
+	struct Header
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t state_key_words;
+		uint64_t puzzle_fingerprint;
+
+		// The puzzle fingerprint leaves the starting pieces out, while the paths in the checkpoint lead back to them.
+		state_key_t starting_state_key;
+
+		uint64_t path_length;
+		uint64_t next_path_length_state_index;
+		uint64_t expanded_state_count;
+
+		uint64_t visited_state_count;
+		uint64_t state_record_count;
+		uint64_t queued_state_count;
+	};
+
+	static constexpr char magic[8] = "SPCKPT";
+	static uint32_t constexpr version = 2;
+
+	bool is_time_for_checkpoint(void);
+	Header get_header(const std::size_t visited_state_count, const std::size_t state_record_count, const std::size_t queued_state_count, const uint32_t next_path_length_state_index);
+	void check_header(const Header &header);
+
+	// Returns whether the previous checkpoint is done being written, and reports it if it failed.
+	bool reap_writer_process(const bool wait);
+
+	SlidingPuzzleSolver &sps;
+
+	pid_t writer_process_id = -1;
+
+	bool is_started = false;
+	std::chrono::steady_clock::time_point last_checkpoint_time;
+	int last_checkpoint_path_length;
+};
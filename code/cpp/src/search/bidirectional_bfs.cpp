@@ -0,0 +1,172 @@
+#include "bidirectional_bfs.hpp"
+
+#include "../sliding_puzzle_solver.hpp"
+
+
+void BidirectionalBfs::solve(void)
+{
+	const state_key_t starting_state_key = sps.get_state_key(sps.get_starting_pieces());
+
+	forward.depth_start_indices.push_back(0);
+	add_state(forward, starting_state_key, sps.get_visited_state_key(starting_state_key), no_parent_index);
+
+	backward.depth_start_indices.push_back(0);
+
+	for (const auto &goal_state_key : sps.get_goal_state_keys())
+	{
+		add_state(backward, goal_state_key, sps.get_visited_state_key(goal_state_key), no_parent_index);
+	}
+
+	Meeting meeting = {0, 0, -1};
+
+	const auto starting_state_iterator = backward.state_indices.find(forward.visited_state_keys[0]);
+
+	if (starting_state_iterator != backward.state_indices.end())
+	{
+		meeting = {0, starting_state_iterator->second, 0};
+	}
+
+	while (meeting.path_length == -1 && !forward.frontier.empty() && !backward.frontier.empty())
+	{
+		update_progress();
+
+		if (forward.frontier.size() <= backward.frontier.size())
+		{
+			expand_frontier(forward, backward, true, meeting);
+		}
+		else
+		{
+			expand_frontier(backward, forward, false, meeting);
+		}
+	}
+
+	update_progress();
+
+	if (meeting.path_length != -1)
+	{
+		sps.progress_counters.depth = meeting.path_length;
+		sps.path = get_path(meeting);
+	}
+}
+
+
+void BidirectionalBfs::add_state(Side &side, const state_key_t &state_key, const state_key_t &visited_state_key, const uint32_t parent_index)
+{
+	const uint32_t state_index = side.visited_state_keys.size();
+
+	side.state_indices.emplace(visited_state_key, state_index);
+	side.visited_state_keys.push_back(visited_state_key);
+	side.parent_indices.push_back(parent_index);
+
+	side.frontier.push_back({state_key, state_index});
+
+	sps.progress_counters.get_slot().unique_state_count++;
+}
+
+
+void BidirectionalBfs::expand_frontier(Side &side, Side &other_side, const bool is_forward, Meeting &meeting)
+{
+	std::vector<QueuedState> frontier;
+	frontier.swap(side.frontier);
+
+	side.depth_start_indices.push_back(side.visited_state_keys.size());
+
+	const int child_depth = side.depth_start_indices.size() - 1;
+
+	ProgressCounters::Slot &progress = sps.progress_counters.get_slot();
+
+	pieces_t pieces = sps.get_starting_pieces();
+	board_t board;
+
+	for (const auto &[state_key, state_index] : frontier)
+	{
+		sps.set_pieces_from_state_key(pieces, state_key);
+		sps.set_board_from_pieces(board, pieces);
+
+		for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+		{
+			Pos &piece_top_left = pieces[piece_index].top_left;
+
+			for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+			{
+				if (sps.cant_move(piece_top_left, piece_index, direction, board))
+				{
+					continue;
+				}
+
+				sps.move(piece_top_left, piece_index, direction, board);
+
+				progress.generated_state_count++;
+
+				const state_key_t child_state_key = sps.get_state_key(pieces);
+				const state_key_t child_visited_state_key = sps.get_visited_state_key(child_state_key);
+
+				if (side.state_indices.find(child_visited_state_key) == side.state_indices.end())
+				{
+					const uint32_t child_state_index = side.visited_state_keys.size();
+
+					add_state(side, child_state_key, child_visited_state_key, state_index);
+
+					const auto other_state_iterator = other_side.state_indices.find(child_visited_state_key);
+
+					if (other_state_iterator != other_side.state_indices.end())
+					{
+						const uint32_t other_state_index = other_state_iterator->second;
+						const int path_length = child_depth + get_depth(other_side, other_state_index);
+
+						// The other side's layers differ in depth, so the whole layer is searched for the shortest meeting.
+						if (meeting.path_length == -1 || path_length < meeting.path_length)
+						{
+							meeting.forward_state_index = is_forward ? child_state_index : other_state_index;
+							meeting.backward_state_index = is_forward ? other_state_index : child_state_index;
+							meeting.path_length = path_length;
+						}
+					}
+				}
+
+				sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), board);
+			}
+		}
+
+		progress.tested_move_count += sps.pieces_count * sps.direction_count;
+		progress.expanded_state_count++;
+	}
+}
+
+
+int BidirectionalBfs::get_depth(const Side &side, const uint32_t state_index)
+{
+	const auto depth_iterator = std::upper_bound(side.depth_start_indices.cbegin(), side.depth_start_indices.cend(), state_index);
+
+	return depth_iterator - side.depth_start_indices.cbegin() - 1;
+}
+
+
+path_t BidirectionalBfs::get_path(const Meeting &meeting)
+{
+	std::vector<state_key_t> visited_state_keys;
+
+	for (uint32_t state_index = meeting.forward_state_index; state_index != no_parent_index; state_index = forward.parent_indices[state_index])
+	{
+		visited_state_keys.push_back(forward.visited_state_keys[state_index]);
+	}
+
+	std::reverse(visited_state_keys.begin(), visited_state_keys.end());
+
+	// The meeting state is already in there, so the backward chain starts at its parent.
+	for (uint32_t state_index = backward.parent_indices[meeting.backward_state_index]; state_index != no_parent_index; state_index = backward.parent_indices[state_index])
+	{
+		visited_state_keys.push_back(backward.visited_state_keys[state_index]);
+	}
+
+	return sps.get_path_through_visited_state_keys(visited_state_keys);
+}
+
+
+void BidirectionalBfs::update_progress(void)
+{
+	ProgressCounters &progress_counters = sps.progress_counters;
+
+	progress_counters.frontier_size = forward.frontier.size() + backward.frontier.size();
+	progress_counters.depth = (forward.depth_start_indices.size() - 1) + (backward.depth_start_indices.size() - 1);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+#include "../pieces.hpp"
+
+
+#include <unordered_map>
+#include <vector>
+
+
+class SlidingPuzzleSolver;
+
+/*
+Searches forward from the starting state and backward from every goal state at the same time,
+always expanding a whole layer of whichever side has the smaller frontier.
+Sliding a piece back undoes a move, so the backward search expands states just like the forward one.
+
+The first layer that reaches a state the other side has visited holds a shortest path,
+which is the shortest of all the meetings found in that layer.
+*/
+class BidirectionalBfs
+{
+public:
+	BidirectionalBfs(SlidingPuzzleSolver &sps_) : sps(sps_) {};
+	void solve(void);
+
+private:
+	static uint32_t constexpr no_parent_index = UINT32_MAX;
+
+	struct Side
+	{
+		// Maps visited state keys to state indices.
+		std::unordered_map<state_key_t, uint32_t, StateKey::HashFunction> state_indices;
+
+		// Indexed by state index.
+		std::vector<state_key_t> visited_state_keys;
+		std::vector<uint32_t> parent_indices;
+
+		// The first state index of every depth, as states are discovered in BFS order.
+		std::vector<uint32_t> depth_start_indices;
+
+		std::vector<QueuedState> frontier;
+	};
+
+	struct Meeting
+	{
+		uint32_t forward_state_index;
+		uint32_t backward_state_index;
+		int path_length;
+	};
+
+	void add_state(Side &side, const state_key_t &state_key, const state_key_t &visited_state_key, const uint32_t parent_index);
+	void expand_frontier(Side &side, Side &other_side, const bool is_forward, Meeting &meeting);
+	int get_depth(const Side &side, const uint32_t state_index);
+	path_t get_path(const Meeting &meeting);
+	void update_progress(void);
+
+	SlidingPuzzleSolver &sps;
+
+	Side forward;
+	Side backward;
+};
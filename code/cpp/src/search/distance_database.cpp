@@ -0,0 +1,383 @@
+#include "distance_database.hpp"
+
+#include "../sliding_puzzle_solver.hpp"
+
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+DistanceDatabase::~DistanceDatabase(void)
+{
+	if (mapping != nullptr)
+	{
+		munmap(mapping, mapping_size);
+	}
+}
+
+
+void DistanceDatabase::generate(const std::filesystem::path &path)
+{
+	FlatStateSet states;
+	states.reserve(sps.expected_state_count);
+
+	// Indexed by the order in which the states were discovered, which is sorted by their distance.
+	std::vector<state_key_t> visited_state_keys;
+	std::vector<uint32_t> depth_start_indices = {0};
+
+	std::vector<state_key_t> layer;
+	std::vector<state_key_t> next_layer;
+
+	for (const auto &goal_state_key : sps.get_goal_state_keys())
+	{
+		states.insert(sps.get_visited_state_key(goal_state_key));
+		visited_state_keys.push_back(sps.get_visited_state_key(goal_state_key));
+		layer.push_back(goal_state_key);
+	}
+
+	pieces_t pieces = sps.get_starting_pieces();
+	board_t board;
+
+	ProgressCounters &progress_counters = sps.progress_counters;
+	ProgressCounters::Slot &progress = progress_counters.get_slot();
+
+	progress.unique_state_count = visited_state_keys.size();
+
+	// Moves can be undone, so searching forward from the goal states finds the distances back to them.
+	while (!layer.empty())
+	{
+		progress_counters.frontier_size = layer.size();
+
+		depth_start_indices.push_back(visited_state_keys.size());
+
+		for (const auto &state_key : layer)
+		{
+			sps.set_pieces_from_state_key(pieces, state_key);
+			sps.set_board_from_pieces(board, pieces);
+
+			for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+			{
+				Pos &piece_top_left = pieces[piece_index].top_left;
+
+				for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+				{
+					if (sps.cant_move(piece_top_left, piece_index, direction, board))
+					{
+						continue;
+					}
+
+					sps.move(piece_top_left, piece_index, direction, board);
+
+					progress.generated_state_count++;
+
+					const state_key_t next_state_key = sps.get_state_key(pieces);
+					const state_key_t next_visited_state_key = sps.get_visited_state_key(next_state_key);
+
+					if (states.insert(next_visited_state_key))
+					{
+						visited_state_keys.push_back(next_visited_state_key);
+						next_layer.push_back(next_state_key);
+
+						progress.unique_state_count++;
+					}
+
+					sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), board);
+				}
+			}
+
+			progress.tested_move_count += sps.pieces_count * sps.direction_count;
+			progress.expanded_state_count++;
+		}
+
+		layer.swap(next_layer);
+		next_layer.clear();
+
+		if (!layer.empty())
+		{
+			progress_counters.depth++;
+		}
+	}
+
+	write(path, visited_state_keys, depth_start_indices);
+}
+
+
+void DistanceDatabase::write(const std::filesystem::path &path, const std::vector<state_key_t> &visited_state_keys, const std::vector<uint32_t> &depth_start_indices)
+{
+	if (depth_start_indices.size() - 1 > UINT16_MAX)
+	{
+		throw std::runtime_error("Some states are more than " + std::to_string(UINT16_MAX) + " moves away from the goal, which doesn't fit in a distance");
+	}
+
+	// A load factor of at most a half keeps the probe sequences of states that aren't in the table short.
+	uint64_t slot_count = 1;
+
+	while (slot_count < 2 * visited_state_keys.size())
+	{
+		slot_count *= 2;
+	}
+
+	const state_key_t empty_key = get_empty_key();
+
+	std::vector<state_key_t> new_slots(slot_count, empty_key);
+	std::vector<uint16_t> new_distances(slot_count, 0);
+
+	Header new_header = {};
+	new_header.magic = magic;
+	new_header.version = version;
+	new_header.state_key_words = state_key_words;
+	new_header.puzzle_fingerprint = sps.get_puzzle_fingerprint();
+	new_header.slot_count = slot_count;
+	new_header.state_count = visited_state_keys.size();
+	new_header.empty_key_distance = no_empty_key_distance;
+
+	uint16_t distance = 0;
+
+	for (uint32_t state_index = 0; state_index < visited_state_keys.size(); ++state_index)
+	{
+		while (state_index >= depth_start_indices[distance + 1])
+		{
+			distance++;
+		}
+
+		const state_key_t &visited_state_key = visited_state_keys[state_index];
+
+		if (visited_state_key == empty_key)
+		{
+			new_header.empty_key_distance = distance;
+			continue;
+		}
+
+		uint64_t slot_index = StateKey::HashFunction()(visited_state_key) & (slot_count - 1);
+
+		while (!(new_slots[slot_index] == empty_key))
+		{
+			slot_index = (slot_index + 1) & (slot_count - 1);
+		}
+
+		new_slots[slot_index] = visited_state_key;
+		new_distances[slot_index] = distance;
+	}
+
+	std::ofstream stream(path, std::ios::binary);
+
+	stream.write(reinterpret_cast<const char *>(&new_header), sizeof(new_header));
+	stream.write(reinterpret_cast<const char *>(new_slots.data()), slot_count * sizeof(state_key_t));
+	stream.write(reinterpret_cast<const char *>(new_distances.data()), slot_count * sizeof(uint16_t));
+
+	if (!stream)
+	{
+		throw std::runtime_error("Couldn't write the distance database " + path.string());
+	}
+}
+
+
+void DistanceDatabase::load(const std::filesystem::path &path)
+{
+	const int fd = open(path.c_str(), O_RDONLY);
+
+	if (fd == -1)
+	{
+		throw std::runtime_error("Couldn't open the distance database " + path.string());
+	}
+
+	struct stat file_stat;
+
+	if (fstat(fd, &file_stat) == -1)
+	{
+		close(fd);
+		throw std::runtime_error("Couldn't get the size of the distance database " + path.string());
+	}
+
+	mapping_size = file_stat.st_size;
+
+	if (mapping_size >= sizeof(Header))
+	{
+		mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+
+	close(fd);
+
+	if (mapping == nullptr || mapping == MAP_FAILED)
+	{
+		mapping = nullptr;
+		throw std::runtime_error("Couldn't map the distance database " + path.string() + " into memory");
+	}
+
+	header = static_cast<const Header *>(mapping);
+
+	if (header->magic != magic || header->version != version)
+	{
+		throw std::runtime_error(path.string() + " isn't a distance database, or one of an older version");
+	}
+
+	if (header->state_key_words != state_key_words || header->puzzle_fingerprint != sps.get_puzzle_fingerprint())
+	{
+		throw std::runtime_error("The distance database " + path.string() + " was generated for another puzzle or STATE_KEY_WORDS");
+	}
+
+	if (mapping_size != sizeof(Header) + header->slot_count * (sizeof(state_key_t) + sizeof(uint16_t)))
+	{
+		throw std::runtime_error("The distance database " + path.string() + " is truncated");
+	}
+
+	slots = reinterpret_cast<const state_key_t *>(header + 1);
+	distances = reinterpret_cast<const uint16_t *>(slots + header->slot_count);
+	slot_index_mask = header->slot_count - 1;
+}
+
+
+int DistanceDatabase::get_distance(const pieces_t &pieces)
+{
+	return get_visited_state_key_distance(sps.get_visited_state_key(sps.get_state_key(pieces)));
+}
+
+
+bool DistanceDatabase::get_best_move(pieces_t &pieces, std::pair<cell_id, piece_direction> &best_move)
+{
+	const int distance = get_distance(pieces);
+
+	if (distance == unknown_distance || distance == 0)
+	{
+		return false;
+	}
+
+	board_t board;
+	sps.set_board_from_pieces(board, pieces);
+
+	for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+	{
+		Pos &piece_top_left = pieces[piece_index].top_left;
+
+		for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+		{
+			if (sps.cant_move(piece_top_left, piece_index, direction, board))
+			{
+				continue;
+			}
+
+			sps.move(piece_top_left, piece_index, direction, board);
+
+			const bool is_closer = get_distance(pieces) == distance - 1;
+
+			sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), board);
+
+			if (is_closer)
+			{
+				best_move = {piece_index, direction};
+				return true;
+			}
+		}
+	}
+
+	throw std::runtime_error("No move of a state in the distance database leads one move closer to the goal");
+}
+
+
+void DistanceDatabase::print_query(void)
+{
+	pieces_t pieces = sps.get_starting_pieces();
+
+	apply_moves(pieces, sps.options.moves);
+
+	const int distance = get_distance(pieces);
+
+	if (distance == unknown_distance)
+	{
+		std::cout << "The goal can't be reached from this state" << std::endl;
+		return;
+	}
+
+	std::cout << "Distance to the goal: " << distance << std::endl;
+
+	path_t path;
+	std::pair<cell_id, piece_direction> best_move;
+
+	while (get_best_move(pieces, best_move))
+	{
+		path.push_back(best_move);
+
+		board_t board;
+		sps.set_board_from_pieces(board, pieces);
+		sps.move(pieces[best_move.first].top_left, best_move.first, best_move.second, board);
+	}
+
+	if (!path.empty())
+	{
+		std::cout << "Best next move: " << sps.piece_labels[path[0].first] << sps.direction_characters[path[0].second] << std::endl;
+	}
+
+	std::cout << std::endl << "Path:" << std::endl;
+
+	for (const auto &[piece_index, direction] : path)
+	{
+		std::cout << sps.piece_labels[piece_index] << sps.direction_characters[direction];
+	}
+
+	std::cout << std::endl;
+}
+
+
+// The moves are written like the printed paths, so "Bv" moves piece B down.
+void DistanceDatabase::apply_moves(pieces_t &pieces, const std::string &moves)
+{
+	board_t board;
+	sps.set_board_from_pieces(board, pieces);
+
+	for (std::size_t move_index = 0; move_index < moves.size(); move_index += 2)
+	{
+		const std::string move = moves.substr(move_index, 2);
+
+		const std::size_t piece_index = sps.piece_labels.find(move[0]);
+		const auto direction_iterator = std::find(sps.direction_characters.cbegin(), sps.direction_characters.cend(), move.size() == 2 ? move[1] : '\0');
+
+		if (move.size() != 2 || piece_index == std::string_view::npos || static_cast<int>(piece_index) >= sps.pieces_count || direction_iterator == sps.direction_characters.cend())
+		{
+			throw std::invalid_argument("\"" + move + "\" isn't a move like \"Bv\"");
+		}
+
+		const piece_direction direction = direction_iterator - sps.direction_characters.cbegin();
+		Pos &piece_top_left = pieces[piece_index].top_left;
+
+		if (sps.cant_move(piece_top_left, piece_index, direction, board))
+		{
+			throw std::invalid_argument("The move \"" + move + "\" is blocked");
+		}
+
+		sps.move(piece_top_left, piece_index, direction, board);
+	}
+}
+
+
+state_key_t DistanceDatabase::get_empty_key(void)
+{
+	state_key_t empty_key;
+	empty_key.words.fill(~uint64_t(0));
+	return empty_key;
+}
+
+
+int DistanceDatabase::get_visited_state_key_distance(const state_key_t &visited_state_key)
+{
+	const state_key_t empty_key = get_empty_key();
+
+	if (visited_state_key == empty_key)
+	{
+		return header->empty_key_distance == no_empty_key_distance ? unknown_distance : static_cast<int>(header->empty_key_distance);
+	}
+
+	for (uint64_t slot_index = StateKey::HashFunction()(visited_state_key) & slot_index_mask; ; slot_index = (slot_index + 1) & slot_index_mask)
+	{
+		if (slots[slot_index] == visited_state_key)
+		{
+			return distances[slot_index];
+		}
+
+		if (slots[slot_index] == empty_key)
+		{
+			return unknown_distance;
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+#include "../pieces.hpp"
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+
+class SlidingPuzzleSolver;
+
+/*
+The number of moves every state that can reach the goal is away from it, found by a single backward BFS from every goal state.
+
+The file is an open addressing hash table of visited state keys with a parallel array of distances, which is mapped into memory,
+so looking up a state takes a hash and a probe or two instead of a search, no matter how big the file is.
+It's not a perfect hash, so the keys themselves are stored to tell states apart, which also makes states that can't reach the goal recognizable.
+
+The best next move of a state is any move that leads to a state one move closer to the goal.
+*/
+class DistanceDatabase
+{
+public:
+	DistanceDatabase(SlidingPuzzleSolver &sps_) : sps(sps_) {};
+	~DistanceDatabase(void);
+
+	DistanceDatabase(const DistanceDatabase &) = delete;
+	DistanceDatabase &operator=(const DistanceDatabase &) = delete;
+
+	void generate(const std::filesystem::path &path);
+	void load(const std::filesystem::path &path);
+
+	// Returns unknown_distance for states that can't reach the goal.
+	int get_distance(const pieces_t &pieces);
+
+	// Returns false for goal states and states that can't reach the goal, which have no best next move.
+	bool get_best_move(pieces_t &pieces, std::pair<cell_id, piece_direction> &best_move);
+
+	// Prints the distance, the best next move and the rest of a shortest path of the starting state after the --moves.
+	void print_query(void);
+
+	static int constexpr unknown_distance = -1;
+
+private:
+	struct Header
+	{
+		std::array<char, 8> magic;
+		uint32_t version;
+		uint32_t state_key_words;
+		uint64_t puzzle_fingerprint;
+		uint64_t slot_count;
+		uint64_t state_count;
+
+		// A state whose key is the empty key can't be stored in a slot, so its distance is stored here instead.
+		uint32_t empty_key_distance;
+		uint32_t padding;
+
+		// Followed by slot_count state keys, and then slot_count uint16_t distances.
+	};
+
+	static std::array<char, 8> constexpr magic = {'S', 'P', 'D', 'D', 'B', '\0', '\0', '\0'};
+	static uint32_t constexpr version = 1;
+
+	static uint32_t constexpr no_empty_key_distance = UINT32_MAX;
+
+	static state_key_t get_empty_key(void);
+
+	void write(const std::filesystem::path &path, const std::vector<state_key_t> &visited_state_keys, const std::vector<uint32_t> &depth_start_indices);
+	int get_visited_state_key_distance(const state_key_t &visited_state_key);
+	void apply_moves(pieces_t &pieces, const std::string &moves);
+
+	SlidingPuzzleSolver &sps;
+
+	void *mapping = nullptr;
+	std::size_t mapping_size = 0;
+
+	const Header *header = nullptr;
+	const state_key_t *slots = nullptr;
+	const uint16_t *distances = nullptr;
+	uint64_t slot_index_mask = 0;
+};
@@ -0,0 +1,358 @@
+#include "enumeration.hpp"
+
+#include "../sliding_puzzle_solver.hpp"
+
+#include <bit>
+
+
+void Enumeration::solve(void)
+{
+	if (sps.options.search == "ranked")
+	{
+		solve_two_bit();
+		return;
+	}
+
+	states.reserve(sps.expected_state_count);
+
+	const state_key_t starting_state_key = sps.get_state_key(sps.get_starting_pieces());
+
+	states.insert(sps.get_visited_state_key(starting_state_key));
+	layer.push_back(starting_state_key);
+
+	ProgressCounters &progress_counters = sps.progress_counters;
+	progress_counters.get_slot().unique_state_count = 1;
+
+	while (!layer.empty())
+	{
+		progress_counters.frontier_size = layer.size();
+
+		DepthStats depth_stats = {layer.size(), 0, 0, 0};
+
+		expand_layer(depth_stats);
+
+		depth_stats.frontier_size = layer.size() + next_layer.size();
+		depths_stats.push_back(depth_stats);
+
+		layer.swap(next_layer);
+		next_layer.clear();
+
+		if (!layer.empty())
+		{
+			progress_counters.depth++;
+		}
+	}
+}
+
+
+void Enumeration::expand_layer(DepthStats &depth_stats)
+{
+	pieces_t pieces = sps.get_starting_pieces();
+	board_t board;
+
+	ProgressCounters &progress_counters = sps.progress_counters;
+	ProgressCounters::Slot &progress = progress_counters.get_slot();
+
+	for (const auto &state_key : layer)
+	{
+		sps.set_pieces_from_state_key(pieces, state_key);
+
+		if (sps.is_goal(pieces))
+		{
+			depth_stats.goal_state_count++;
+		}
+
+		sps.set_board_from_pieces(board, pieces);
+
+		for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+		{
+			Pos &piece_top_left = pieces[piece_index].top_left;
+
+			for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+			{
+				if (sps.cant_move(piece_top_left, piece_index, direction, board))
+				{
+					continue;
+				}
+
+				depth_stats.move_count++;
+				progress.generated_state_count++;
+
+				sps.move(piece_top_left, piece_index, direction, board);
+
+				const state_key_t next_state_key = sps.get_state_key(pieces);
+
+				if (states.insert(sps.get_visited_state_key(next_state_key)))
+				{
+					next_layer.push_back(next_state_key);
+
+					progress.unique_state_count++;
+				}
+
+				sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), board);
+			}
+		}
+
+		progress.tested_move_count += sps.pieces_count * sps.direction_count;
+		progress.expanded_state_count++;
+
+		progress_counters.visited_state_set_size = states.size();
+		progress_counters.visited_state_set_capacity = states.capacity();
+	}
+}
+
+
+void Enumeration::solve_two_bit(void)
+{
+	state_ranker.initialize();
+
+	const std::size_t thread_count = sps.options.thread_count;
+
+	two_bit_words = std::vector<std::atomic<uint64_t>>((state_ranker.get_state_count() + two_bit_values_per_word - 1) / two_bit_values_per_word);
+
+	thread_depths_stats.resize(thread_count);
+	thread_next_state_counts.resize(thread_count);
+
+	pieces_t pieces = sps.get_starting_pieces();
+	pieces_t mirrored_pieces = pieces;
+
+	bool is_mirrored;
+	set_two_bit_value_if_unseen(state_ranker.get_visited_rank(pieces, mirrored_pieces, is_mirrored), 1);
+
+	ProgressCounters &progress_counters = sps.progress_counters;
+	progress_counters.get_slot().unique_state_count = 1;
+
+	std::size_t layer_size = 1;
+
+	for (std::size_t depth = 0; layer_size != 0; ++depth)
+	{
+		progress_counters.frontier_size = layer_size;
+
+		const uint64_t current_value = depth % 2 == 0 ? 1 : 2;
+		const uint64_t next_value = 3 - current_value;
+
+		std::vector<std::thread> threads;
+
+		// The calling thread does its share of the work as thread 0.
+		for (std::size_t thread_index = 1; thread_index < thread_count; ++thread_index)
+		{
+			threads.emplace_back(&Enumeration::sweep_two_bit_words, this, thread_index, current_value, next_value);
+		}
+
+		sweep_two_bit_words(0, current_value, next_value);
+
+		for (auto &thread : threads)
+		{
+			thread.join();
+		}
+
+		DepthStats depth_stats = {0, 0, 0, 0};
+		std::size_t next_layer_size = 0;
+
+		for (std::size_t thread_index = 0; thread_index < thread_count; ++thread_index)
+		{
+			depth_stats.state_count += thread_depths_stats[thread_index].state_count;
+			depth_stats.goal_state_count += thread_depths_stats[thread_index].goal_state_count;
+			depth_stats.move_count += thread_depths_stats[thread_index].move_count;
+
+			next_layer_size += thread_next_state_counts[thread_index];
+		}
+
+		depth_stats.frontier_size = layer_size + next_layer_size;
+		depths_stats.push_back(depth_stats);
+
+		layer_size = next_layer_size;
+
+		if (layer_size != 0)
+		{
+			progress_counters.depth++;
+		}
+	}
+}
+
+
+// Expands the states of the current layer in this thread's range of words, and marks them as done.
+void Enumeration::sweep_two_bit_words(const std::size_t thread_index, const uint64_t current_value, const uint64_t next_value)
+{
+	DepthStats &depth_stats = thread_depths_stats[thread_index];
+	depth_stats = {0, 0, 0, 0};
+
+	std::size_t &next_state_count = thread_next_state_counts[thread_index];
+	next_state_count = 0;
+
+	ProgressCounters::Slot &progress = sps.progress_counters.get_slot(thread_index);
+
+	pieces_t pieces = sps.get_starting_pieces();
+	pieces_t mirrored_pieces = pieces;
+	board_t board;
+
+	const std::size_t thread_count = thread_depths_stats.size();
+	const std::size_t first_word_index = two_bit_words.size() * thread_index / thread_count;
+	const std::size_t last_word_index = two_bit_words.size() * (thread_index + 1) / thread_count;
+
+	// The lowest bit of every two-bit value.
+	const uint64_t low_bits = 0x5555555555555555ULL;
+
+	for (std::size_t word_index = first_word_index; word_index < last_word_index; ++word_index)
+	{
+		const uint64_t word = two_bit_words[word_index].load(std::memory_order_relaxed);
+
+		const uint64_t value_low_bits = word & low_bits;
+		const uint64_t value_high_bits = (word >> 1) & low_bits;
+
+		// The lowest bit of every value of the current layer.
+		uint64_t current_bits = current_value == 1 ? value_low_bits & ~value_high_bits : value_high_bits & ~value_low_bits;
+
+		for (; current_bits != 0; current_bits &= current_bits - 1)
+		{
+			const int bit_index = std::countr_zero(current_bits);
+			const uint64_t rank = word_index * two_bit_values_per_word + bit_index / 2;
+
+			state_ranker.set_pieces_from_rank(pieces, rank);
+
+			depth_stats.state_count++;
+
+			if (sps.is_goal(pieces))
+			{
+				depth_stats.goal_state_count++;
+			}
+
+			sps.set_board_from_pieces(board, pieces);
+
+			for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+			{
+				Pos &piece_top_left = pieces[piece_index].top_left;
+
+				for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+				{
+					if (sps.cant_move(piece_top_left, piece_index, direction, board))
+					{
+						continue;
+					}
+
+					depth_stats.move_count++;
+					progress.generated_state_count++;
+
+					sps.move(piece_top_left, piece_index, direction, board);
+
+					bool is_mirrored;
+
+					if (set_two_bit_value_if_unseen(state_ranker.get_visited_rank(pieces, mirrored_pieces, is_mirrored), next_value))
+					{
+						next_state_count++;
+						progress.unique_state_count++;
+					}
+
+					sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), board);
+				}
+			}
+
+			progress.tested_move_count += sps.pieces_count * sps.direction_count;
+			progress.expanded_state_count++;
+
+			two_bit_words[word_index].fetch_or(done << bit_index, std::memory_order_relaxed);
+		}
+	}
+}
+
+
+// Other threads can be changing other values in the same word, so it's only written if it didn't change in the meantime.
+bool Enumeration::set_two_bit_value_if_unseen(const uint64_t rank, const uint64_t value)
+{
+	std::atomic<uint64_t> &word = two_bit_words[rank / two_bit_values_per_word];
+	const int bit_index = rank % two_bit_values_per_word * 2;
+
+	uint64_t old_word = word.load(std::memory_order_relaxed);
+
+	do
+	{
+		if (((old_word >> bit_index) & done) != unseen)
+		{
+			return false;
+		}
+	}
+	while (!word.compare_exchange_weak(old_word, old_word | (value << bit_index), std::memory_order_relaxed));
+
+	return true;
+}
+
+
+void Enumeration::write_stats(void)
+{
+	const std::string &stats_path = sps.options.stats_out_path;
+
+	if (stats_path.empty())
+	{
+		std::cout << std::endl;
+		write_csv(std::cout);
+		return;
+	}
+
+	std::ofstream stream(stats_path);
+
+	if (!stream)
+	{
+		throw std::runtime_error("Couldn't create the stats file " + stats_path);
+	}
+
+	if (std::filesystem::path(stats_path).extension() == ".json")
+	{
+		write_json(stream);
+	}
+	else
+	{
+		write_csv(stream);
+	}
+}
+
+
+void Enumeration::write_csv(std::ostream &stream)
+{
+	stream << "depth,states,goal_states,average_branching_factor,frontier_size" << std::endl;
+
+	for (std::size_t depth = 0; depth < depths_stats.size(); ++depth)
+	{
+		const DepthStats &depth_stats = depths_stats[depth];
+
+		stream << depth << "," << depth_stats.state_count << "," << depth_stats.goal_state_count << ","
+			<< static_cast<double>(depth_stats.move_count) / depth_stats.state_count << "," << depth_stats.frontier_size << std::endl;
+	}
+}
+
+
+void Enumeration::write_json(std::ostream &stream)
+{
+	nlohmann::ordered_json depths_json = nlohmann::ordered_json::array();
+
+	std::size_t state_count = 0;
+	std::size_t goal_state_count = 0;
+	std::size_t peak_frontier_size = 0;
+
+	for (std::size_t depth = 0; depth < depths_stats.size(); ++depth)
+	{
+		const DepthStats &depth_stats = depths_stats[depth];
+
+		depths_json.push_back({
+			{"depth", depth},
+			{"states", depth_stats.state_count},
+			{"goal_states", depth_stats.goal_state_count},
+			{"average_branching_factor", static_cast<double>(depth_stats.move_count) / depth_stats.state_count},
+			{"frontier_size", depth_stats.frontier_size}
+		});
+
+		state_count += depth_stats.state_count;
+		goal_state_count += depth_stats.goal_state_count;
+		peak_frontier_size = std::max(peak_frontier_size, depth_stats.frontier_size);
+	}
+
+	const nlohmann::ordered_json stats_json = {
+		{"puzzle", sps.options.puzzle_name},
+		{"states", state_count},
+		{"goal_states", goal_state_count},
+		{"max_depth", depths_stats.size() - 1},
+		{"peak_frontier_size", peak_frontier_size},
+		{"depths", depths_json}
+	};
+
+	stream << stats_json.dump(1, '\t') << std::endl;
+}
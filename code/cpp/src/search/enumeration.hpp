@@ -0,0 +1,88 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+#include "../pieces.hpp"
+#include "../state/flat_state_set.hpp"
+#include "../state/state_ranker.hpp"
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+
+class SlidingPuzzleSolver;
+
+/*
+Runs the BFS until every reachable state has been visited, instead of stopping at the first goal state,
+and collects statistics about every depth along the way.
+
+Only the visited state keys and the keys of two layers are kept around, as no path has to be rebuilt.
+The counts are of visited states, so a state and its mirror image or its identical piece swaps count once.
+
+With "--search ranked", there are no keys at all. Every placement of the pieces gets two bits instead,
+which say whether it's unseen, in the current layer, in the next layer or done,
+and every layer is a sweep over all of them, which the threads split into equal ranges.
+*/
+class Enumeration
+{
+public:
+	Enumeration(SlidingPuzzleSolver &sps_) : sps(sps_), state_ranker(sps_) {};
+	void solve(void);
+
+	// Writes JSON if the path given with --stats-out ends in ".json", CSV to it otherwise, and CSV to stdout without --stats-out.
+	void write_stats(void);
+
+private:
+	struct DepthStats
+	{
+		std::size_t state_count;
+		std::size_t goal_state_count;
+
+		// The number of moves that could be made from the states of this depth, whether they led to new states or not.
+		std::size_t move_count;
+
+		// The number of states of this and the next depth, which are the ones held at the end of expanding this depth.
+		std::size_t frontier_size;
+	};
+
+	// The two-bit values of the current and next layer trade places every layer, so the next layer never has to be relabeled.
+	enum two_bit_value : uint64_t
+	{
+		unseen = 0,
+		done = 3
+	};
+
+	static std::size_t constexpr two_bit_values_per_word = 32;
+
+	void expand_layer(DepthStats &depth_stats);
+
+	void solve_two_bit(void);
+	void sweep_two_bit_words(const std::size_t thread_index, const uint64_t current_value, const uint64_t next_value);
+	bool set_two_bit_value_if_unseen(const uint64_t rank, const uint64_t value);
+
+	void write_csv(std::ostream &stream);
+	void write_json(std::ostream &stream);
+
+	SlidingPuzzleSolver &sps;
+
+	FlatStateSet states;
+
+	std::vector<state_key_t> layer;
+	std::vector<state_key_t> next_layer;
+
+	StateRanker state_ranker;
+
+	// Indexed by rank divided by two_bit_values_per_word.
+	std::vector<std::atomic<uint64_t>> two_bit_words;
+
+	// Indexed by thread index, these are summed up after every sweep.
+	std::vector<DepthStats> thread_depths_stats;
+	std::vector<std::size_t> thread_next_state_counts;
+
+	// Indexed by depth.
+	std::vector<DepthStats> depths_stats;
+};
@@ -0,0 +1,490 @@
+#include "external_bfs.hpp"
+
+#include "../sliding_puzzle_solver.hpp"
+
+#include <queue>
+
+
+void ExternalBfs::solve(void)
+{
+	scratch_directory_path = sps.options.scratch_directory_path;
+
+	if (scratch_directory_path.empty())
+	{
+		throw std::invalid_argument("The external BFS needs a --scratch-dir to keep its layers in");
+	}
+
+	std::filesystem::create_directories(scratch_directory_path);
+
+	buffer_capacity = std::max<std::size_t>(1, static_cast<std::size_t>(sps.options.buffer_megabytes) * 1024 * 1024 / sizeof(state_key_t));
+	buffer.reserve(buffer_capacity);
+
+	load_progress();
+
+	// An interrupted layer can have left runs behind, which would otherwise only be overwritten as far as the new runs go.
+	for (std::size_t run_index = 0; std::filesystem::remove(get_run_path(run_index)); ++run_index)
+	{
+	}
+
+	if (layer_count == 0)
+	{
+		const state_key_t starting_visited_state_key = sps.get_visited_state_key(sps.get_state_key(sps.get_starting_pieces()));
+
+		std::ofstream stream(get_layer_path(0), std::ios::binary);
+		stream.write(reinterpret_cast<const char *>(&starting_visited_state_key), sizeof(state_key_t));
+
+		if (!stream)
+		{
+			throw std::runtime_error("Couldn't write " + get_layer_path(0).string());
+		}
+
+		layer_count = 1;
+		state_count = 1;
+		save_progress();
+	}
+
+	ProgressCounters &progress_counters = sps.progress_counters;
+
+	// The states of the next layer are only known to be unique once the runs are merged.
+	progress_counters.get_slot().unique_state_count = state_count;
+
+	for (std::size_t depth = layer_count - 1; ; ++depth)
+	{
+		progress_counters.depth = depth;
+
+		state_key_t goal_state_key;
+
+		if (expand_layer(depth, goal_state_key))
+		{
+			sps.path = get_path(goal_state_key, depth);
+			break;
+		}
+
+		const std::size_t next_layer_size = merge_runs(depth);
+
+		if (next_layer_size == 0)
+		{
+			break;
+		}
+
+		layer_count++;
+		state_count += next_layer_size;
+		save_progress();
+
+		progress_counters.get_slot().unique_state_count = state_count;
+	}
+
+	// Only the files this wrote are removed, as the scratch directory could hold other things too.
+	for (std::size_t depth = 0; depth < layer_count; ++depth)
+	{
+		std::filesystem::remove(get_layer_path(depth));
+	}
+
+	// Finding the goal stops the expansion before merge_runs() removes the runs it already wrote.
+	for (std::size_t run_index = 0; run_index < run_count; ++run_index)
+	{
+		std::filesystem::remove(get_run_path(run_index));
+	}
+
+	std::filesystem::remove(scratch_directory_path / "progress.json");
+}
+
+
+void ExternalBfs::load_progress(void)
+{
+	const std::filesystem::path progress_path = scratch_directory_path / "progress.json";
+
+	if (!std::filesystem::exists(progress_path))
+	{
+		return;
+	}
+
+	std::ifstream stream(progress_path);
+	const json progress_json = json::parse(stream);
+
+	if (progress_json["puzzle_fingerprint"].get<uint64_t>() != sps.get_puzzle_fingerprint() || progress_json["state_key_words"].get<std::size_t>() != state_key_words)
+	{
+		throw std::runtime_error("The scratch directory " + scratch_directory_path.string() + " holds the layers of another puzzle or build");
+	}
+
+	// The puzzle fingerprint leaves the starting pieces out, while the first layer holds the starting state.
+	const json starting_state_key_json = sps.get_state_key(sps.get_starting_pieces()).words;
+
+	if (progress_json.value("starting_state_key", json()) != starting_state_key_json)
+	{
+		throw std::runtime_error("The scratch directory " + scratch_directory_path.string() + " holds the layers of other starting pieces");
+	}
+
+	layer_count = progress_json["layer_count"].get<std::size_t>();
+	state_count = progress_json["state_count"].get<std::size_t>();
+
+	std::cout << "Resuming the external BFS at depth " << layer_count - 1 << " with " << state_count << " states" << std::endl;
+}
+
+
+// Written to a temporary file that replaces the old one, so an interruption can't leave half of it behind.
+void ExternalBfs::save_progress(void)
+{
+	const nlohmann::ordered_json progress_json = {
+		{"puzzle_fingerprint", sps.get_puzzle_fingerprint()},
+		{"state_key_words", state_key_words},
+		{"starting_state_key", sps.get_state_key(sps.get_starting_pieces()).words},
+		{"layer_count", layer_count},
+		{"state_count", state_count}
+	};
+
+	const std::filesystem::path progress_path = scratch_directory_path / "progress.json";
+	const std::filesystem::path temporary_progress_path = scratch_directory_path / "progress.json.tmp";
+
+	{
+		std::ofstream stream(temporary_progress_path);
+		stream << progress_json.dump(1, '\t') << std::endl;
+
+		if (!stream)
+		{
+			throw std::runtime_error("Couldn't write " + temporary_progress_path.string());
+		}
+	}
+
+	std::filesystem::rename(temporary_progress_path, progress_path);
+}
+
+
+// Fills the runs with the visited state keys of every state the layer leads to, and returns whether it has a goal state.
+bool ExternalBfs::expand_layer(const std::size_t depth, state_key_t &goal_state_key)
+{
+	StateKeyReader reader(get_layer_path(depth));
+
+	pieces_t pieces = sps.get_starting_pieces();
+	board_t board;
+
+	ProgressCounters::Slot &progress = sps.progress_counters.get_slot();
+
+	buffer.clear();
+	run_count = 0;
+
+	state_key_t state_key;
+
+	while (reader.read(state_key))
+	{
+		sps.set_pieces_from_state_key(pieces, state_key);
+
+		if (sps.is_goal(pieces))
+		{
+			goal_state_key = state_key;
+			return true;
+		}
+
+		sps.set_board_from_pieces(board, pieces);
+
+		for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+		{
+			Pos &piece_top_left = pieces[piece_index].top_left;
+
+			for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+			{
+				if (sps.cant_move(piece_top_left, piece_index, direction, board))
+				{
+					continue;
+				}
+
+				sps.move(piece_top_left, piece_index, direction, board);
+
+				progress.generated_state_count++;
+
+				buffer.push_back(sps.get_visited_state_key(sps.get_state_key(pieces)));
+
+				if (buffer.size() == buffer_capacity)
+				{
+					write_run();
+				}
+
+				sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), board);
+			}
+		}
+
+		sps.progress_counters.frontier_size = buffer.size();
+
+		progress.tested_move_count += sps.pieces_count * sps.direction_count;
+		progress.expanded_state_count++;
+	}
+
+	if (!buffer.empty())
+	{
+		write_run();
+	}
+
+	return false;
+}
+
+
+void ExternalBfs::write_run(void)
+{
+	std::sort(buffer.begin(), buffer.end());
+	buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+
+	const std::filesystem::path run_path = get_run_path(run_count);
+
+	std::ofstream stream(run_path, std::ios::binary);
+	stream.write(reinterpret_cast<const char *>(buffer.data()), buffer.size() * sizeof(state_key_t));
+
+	if (!stream)
+	{
+		throw std::runtime_error("Couldn't write " + run_path.string());
+	}
+
+	run_count++;
+	buffer.clear();
+}
+
+
+/*
+Merges the runs into the file of the next layer, leaving out the duplicates and the states of this and the previous layer,
+and returns the number of states in it.
+*/
+std::size_t ExternalBfs::merge_runs(const std::size_t depth)
+{
+	std::vector<StateKeyReader> run_readers;
+	run_readers.reserve(run_count);
+
+	typedef std::pair<state_key_t, std::size_t> run_head_t;
+	std::priority_queue<run_head_t, std::vector<run_head_t>, std::greater<run_head_t>> run_heads;
+
+	for (std::size_t run_index = 0; run_index < run_count; ++run_index)
+	{
+		run_readers.emplace_back(get_run_path(run_index));
+
+		state_key_t state_key;
+
+		if (run_readers.back().read(state_key))
+		{
+			run_heads.push({state_key, run_index});
+		}
+	}
+
+	std::vector<StateKeyReader> previous_layer_readers;
+	std::vector<state_key_t> previous_layer_heads;
+	std::vector<bool> previous_layer_has_heads;
+
+	for (std::size_t previous_depth = depth > 0 ? depth - 1 : 0; previous_depth <= depth; ++previous_depth)
+	{
+		previous_layer_readers.emplace_back(get_layer_path(previous_depth));
+
+		state_key_t state_key;
+		previous_layer_has_heads.push_back(previous_layer_readers.back().read(state_key));
+		previous_layer_heads.push_back(state_key);
+	}
+
+	const std::filesystem::path temporary_layer_path = get_layer_path(depth + 1).string() + ".tmp";
+	std::ofstream stream(temporary_layer_path, std::ios::binary);
+
+	std::size_t next_layer_size = 0;
+	bool has_merged_state_key = false;
+	state_key_t merged_state_key;
+
+	while (!run_heads.empty())
+	{
+		const auto [state_key, run_index] = run_heads.top();
+		run_heads.pop();
+
+		state_key_t next_state_key;
+
+		if (run_readers[run_index].read(next_state_key))
+		{
+			run_heads.push({next_state_key, run_index});
+		}
+
+		if (has_merged_state_key && state_key == merged_state_key)
+		{
+			continue;
+		}
+
+		has_merged_state_key = true;
+		merged_state_key = state_key;
+
+		bool is_in_previous_layer = false;
+
+		for (std::size_t layer_index = 0; layer_index < previous_layer_readers.size(); ++layer_index)
+		{
+			state_key_t &head = previous_layer_heads[layer_index];
+
+			while (previous_layer_has_heads[layer_index] && head < state_key)
+			{
+				previous_layer_has_heads[layer_index] = previous_layer_readers[layer_index].read(head);
+			}
+
+			if (previous_layer_has_heads[layer_index] && head == state_key)
+			{
+				is_in_previous_layer = true;
+			}
+		}
+
+		if (!is_in_previous_layer)
+		{
+			stream.write(reinterpret_cast<const char *>(&state_key), sizeof(state_key_t));
+			next_layer_size++;
+		}
+	}
+
+	stream.close();
+
+	if (!stream)
+	{
+		throw std::runtime_error("Couldn't write " + temporary_layer_path.string());
+	}
+
+	run_readers.clear();
+
+	for (std::size_t run_index = 0; run_index < run_count; ++run_index)
+	{
+		std::filesystem::remove(get_run_path(run_index));
+	}
+
+	if (next_layer_size == 0)
+	{
+		std::filesystem::remove(temporary_layer_path);
+	}
+	else
+	{
+		std::filesystem::rename(temporary_layer_path, get_layer_path(depth + 1));
+	}
+
+	return next_layer_size;
+}
+
+
+// Walks back from the goal state, every time to a state that the previous layer's file has.
+path_t ExternalBfs::get_path(state_key_t state_key, const std::size_t depth)
+{
+	std::vector<state_key_t> visited_state_keys = {state_key};
+
+	pieces_t pieces = sps.get_starting_pieces();
+	board_t board;
+
+	for (std::size_t previous_depth = depth; previous_depth-- > 0; )
+	{
+		sps.set_pieces_from_state_key(pieces, state_key);
+		sps.set_board_from_pieces(board, pieces);
+
+		bool found_previous_state = false;
+
+		for (cell_id piece_index = 0; piece_index != sps.pieces_count && !found_previous_state; ++piece_index)
+		{
+			Pos &piece_top_left = pieces[piece_index].top_left;
+
+			for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+			{
+				if (sps.cant_move(piece_top_left, piece_index, direction, board))
+				{
+					continue;
+				}
+
+				sps.move(piece_top_left, piece_index, direction, board);
+
+				const state_key_t previous_state_key = sps.get_visited_state_key(sps.get_state_key(pieces));
+
+				sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), board);
+
+				if (is_in_layer(previous_state_key, previous_depth))
+				{
+					state_key = previous_state_key;
+					found_previous_state = true;
+					break;
+				}
+			}
+		}
+
+		if (!found_previous_state)
+		{
+			throw std::logic_error("No state of the previous layer leads to a state of the path");
+		}
+
+		visited_state_keys.push_back(state_key);
+	}
+
+	std::reverse(visited_state_keys.begin(), visited_state_keys.end());
+
+	return sps.get_path_through_visited_state_keys(visited_state_keys);
+}
+
+
+// Binary searches the sorted file of the layer.
+bool ExternalBfs::is_in_layer(const state_key_t &state_key, const std::size_t depth)
+{
+	const std::filesystem::path layer_path = get_layer_path(depth);
+
+	std::ifstream stream(layer_path, std::ios::binary);
+
+	std::size_t low = 0;
+	std::size_t high = std::filesystem::file_size(layer_path) / sizeof(state_key_t);
+
+	while (low < high)
+	{
+		const std::size_t middle = low + (high - low) / 2;
+
+		state_key_t middle_state_key;
+		stream.seekg(middle * sizeof(state_key_t));
+		stream.read(reinterpret_cast<char *>(&middle_state_key), sizeof(state_key_t));
+
+		if (middle_state_key == state_key)
+		{
+			return true;
+		}
+
+		if (middle_state_key < state_key)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return false;
+}
+
+
+std::filesystem::path ExternalBfs::get_layer_path(const std::size_t depth)
+{
+	return scratch_directory_path / ("layer_" + std::to_string(depth) + ".keys");
+}
+
+
+std::filesystem::path ExternalBfs::get_run_path(const std::size_t run_index)
+{
+	return scratch_directory_path / ("run_" + std::to_string(run_index) + ".keys");
+}
+
+
+ExternalBfs::StateKeyReader::StateKeyReader(const std::filesystem::path &path)
+	: stream(path, std::ios::binary)
+{
+	if (!stream)
+	{
+		throw std::runtime_error("Couldn't open " + path.string());
+	}
+}
+
+
+bool ExternalBfs::StateKeyReader::read(state_key_t &state_key)
+{
+	if (buffer_index == buffer.size())
+	{
+		buffer.resize(buffer_state_key_count);
+
+		stream.read(reinterpret_cast<char *>(buffer.data()), buffer_state_key_count * sizeof(state_key_t));
+
+		buffer.resize(stream.gcount() / sizeof(state_key_t));
+		buffer_index = 0;
+
+		if (buffer.empty())
+		{
+			return false;
+		}
+	}
+
+	state_key = buffer[buffer_index++];
+
+	return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+#include "../pieces.hpp"
+
+
+#include <filesystem>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+class SlidingPuzzleSolver;
+
+/*
+A BFS for puzzles whose states don't fit in memory, which keeps every layer on disk as a sorted file of visited state keys.
+
+The keys of the states that the current layer leads to are collected in a buffer of --buffer-mb megabytes,
+which is sorted and written to the scratch directory as a run whenever it's full.
+Merging the runs drops the duplicates, and every key that is in the current or previous layer as well.
+No move can skip a layer, so that's all it takes to leave only the states that weren't visited before.
+Every file is only ever read and written front to back, except for the lookups that rebuild the path.
+
+The scratch directory remembers how many layers are complete,
+so running the same puzzle with the same scratch directory again goes on from the last complete layer.
+*/
+class ExternalBfs
+{
+public:
+	ExternalBfs(SlidingPuzzleSolver &sps_) : sps(sps_) {};
+	void solve(void);
+
+private:
+	// Reads a file of state keys front to back, a buffer at a time.
+	class StateKeyReader
+	{
+	public:
+		StateKeyReader(const std::filesystem::path &path);
+		bool read(state_key_t &state_key);
+
+	private:
+		static std::size_t constexpr buffer_state_key_count = 1 << 14;
+
+		std::ifstream stream;
+		std::vector<state_key_t> buffer;
+		std::size_t buffer_index = 0;
+	};
+
+	void load_progress(void);
+	void save_progress(void);
+
+	bool expand_layer(const std::size_t depth, state_key_t &goal_state_key);
+	void write_run(void);
+	std::size_t merge_runs(const std::size_t depth);
+
+	path_t get_path(state_key_t state_key, const std::size_t depth);
+	bool is_in_layer(const state_key_t &state_key, const std::size_t depth);
+
+	std::filesystem::path get_layer_path(const std::size_t depth);
+	std::filesystem::path get_run_path(const std::size_t run_index);
+
+	SlidingPuzzleSolver &sps;
+
+	std::filesystem::path scratch_directory_path;
+
+	// The number of layers whose files are complete, and the number of states in all of them.
+	std::size_t layer_count = 0;
+	std::size_t state_count = 0;
+
+	std::vector<state_key_t> buffer;
+	std::size_t buffer_capacity;
+
+	std::size_t run_count = 0;
+};
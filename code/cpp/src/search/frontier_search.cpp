@@ -0,0 +1,157 @@
+#include "frontier_search.hpp"
+
+#include "../sliding_puzzle_solver.hpp"
+
+
+void FrontierSearch::solve(void)
+{
+	const state_key_t starting_state_key = sps.get_visited_state_key(sps.get_state_key(sps.get_starting_pieces()));
+
+	state_key_t goal_state_key;
+	state_key_t middle_state_key;
+
+	const int path_length = search(starting_state_key, nullptr, not_found, goal_state_key, middle_state_key);
+
+	if (path_length == not_found || !sps.options.divide_and_conquer)
+	{
+		return;
+	}
+
+	std::vector<state_key_t> path_state_keys = {starting_state_key};
+	add_path_state_keys(path_state_keys, starting_state_key, goal_state_key, path_length);
+
+	sps.path = sps.get_path_through_visited_state_keys(path_state_keys);
+}
+
+
+int FrontierSearch::search(const state_key_t &starting_state_key, const state_key_t *target_state_key, const int middle_depth, state_key_t &found_state_key, state_key_t &middle_state_key)
+{
+	// Only the first search reports its progress, as the ones that rebuild the path visit the same states again.
+	const bool is_first_search = target_state_key == nullptr;
+
+	Layer previous_layer;
+	Layer layer;
+	Layer next_layer;
+
+	layer.visited_state_keys.push_back(starting_state_key);
+	layer.visited_states.insert(starting_state_key);
+
+	if (middle_depth == 0)
+	{
+		layer.middle_state_keys.push_back(starting_state_key);
+	}
+
+	pieces_t pieces = sps.get_starting_pieces();
+	board_t board;
+
+	ProgressCounters &progress_counters = sps.progress_counters;
+	ProgressCounters::Slot &progress = progress_counters.get_slot();
+
+	for (int depth = 0; !layer.visited_state_keys.empty(); ++depth)
+	{
+		if (is_first_search)
+		{
+			progress_counters.depth = depth;
+			progress_counters.frontier_size = layer.visited_state_keys.size();
+		}
+
+		for (std::size_t layer_index = 0; layer_index < layer.visited_state_keys.size(); ++layer_index)
+		{
+			const state_key_t &state_key = layer.visited_state_keys[layer_index];
+
+			sps.set_pieces_from_state_key(pieces, state_key);
+
+			if (is_first_search ? sps.is_goal(pieces) : state_key == *target_state_key)
+			{
+				found_state_key = state_key;
+
+				if (middle_depth != not_found && middle_depth <= depth)
+				{
+					middle_state_key = layer.middle_state_keys[layer_index];
+				}
+
+				return depth;
+			}
+
+			sps.set_board_from_pieces(board, pieces);
+
+			for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+			{
+				Pos &piece_top_left = pieces[piece_index].top_left;
+
+				for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+				{
+					if (sps.cant_move(piece_top_left, piece_index, direction, board))
+					{
+						continue;
+					}
+
+					sps.move(piece_top_left, piece_index, direction, board);
+
+					progress.generated_state_count++;
+
+					const state_key_t next_state_key = sps.get_visited_state_key(sps.get_state_key(pieces));
+
+					if (!previous_layer.visited_states.contains(next_state_key) && !layer.visited_states.contains(next_state_key) && next_layer.visited_states.insert(next_state_key))
+					{
+						next_layer.visited_state_keys.push_back(next_state_key);
+
+						if (middle_depth == depth + 1)
+						{
+							next_layer.middle_state_keys.push_back(next_state_key);
+						}
+						else if (middle_depth != not_found && middle_depth <= depth)
+						{
+							next_layer.middle_state_keys.push_back(layer.middle_state_keys[layer_index]);
+						}
+
+						if (is_first_search)
+						{
+							progress.unique_state_count++;
+						}
+					}
+
+					sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), board);
+				}
+			}
+
+			progress.tested_move_count += sps.pieces_count * sps.direction_count;
+			progress.expanded_state_count++;
+		}
+
+		previous_layer = std::move(layer);
+		layer = std::move(next_layer);
+		next_layer = Layer();
+	}
+
+	return not_found;
+}
+
+
+// Adds every state after the starting state up to and including the ending state.
+void FrontierSearch::add_path_state_keys(std::vector<state_key_t> &path_state_keys, const state_key_t &starting_state_key, const state_key_t &ending_state_key, const int path_length)
+{
+	if (path_length == 0)
+	{
+		return;
+	}
+
+	if (path_length == 1)
+	{
+		path_state_keys.push_back(ending_state_key);
+		return;
+	}
+
+	const int middle_depth = path_length / 2;
+
+	state_key_t found_state_key;
+	state_key_t middle_state_key;
+
+	if (search(starting_state_key, &ending_state_key, middle_depth, found_state_key, middle_state_key) != path_length)
+	{
+		throw std::logic_error("Searching the path again found a different path length");
+	}
+
+	add_path_state_keys(path_state_keys, starting_state_key, middle_state_key, middle_depth);
+	add_path_state_keys(path_state_keys, middle_state_key, ending_state_key, path_length - middle_depth);
+}
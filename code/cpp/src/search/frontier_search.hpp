@@ -0,0 +1,51 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+#include "../pieces.hpp"
+#include "../state/flat_state_set.hpp"
+
+
+#include <vector>
+
+
+class SlidingPuzzleSolver;
+
+/*
+A BFS that forgets every layer that is more than one layer behind the one being expanded.
+Every move can be undone, so a state the current layer leads to is either new, or in the current or previous layer,
+and the memory it needs only grows with the widest three layers instead of with every visited state.
+
+Without a closed set there's nothing to walk the path back through, so only its length is known,
+unless --divide-and-conquer is given. That searches from the start to the goal state again,
+with every state of the second half remembering which state of the middle layer it descends from,
+and then does the same for both halves until every state of the path is known.
+*/
+class FrontierSearch
+{
+public:
+	FrontierSearch(SlidingPuzzleSolver &sps_) : sps(sps_) {};
+	void solve(void);
+
+private:
+	static int const not_found = -1;
+
+	struct Layer
+	{
+		std::vector<state_key_t> visited_state_keys;
+		FlatStateSet visited_states;
+
+		// Indexed like visited_state_keys, only when a middle depth is given.
+		std::vector<state_key_t> middle_state_keys;
+	};
+
+	/*
+	Searches from the starting state until it expands a goal state, or the target state if there is one,
+	and returns its depth, or not_found. The middle state is the state at the middle depth it descends from.
+	*/
+	int search(const state_key_t &starting_state_key, const state_key_t *target_state_key, const int middle_depth, state_key_t &found_state_key, state_key_t &middle_state_key);
+
+	void add_path_state_keys(std::vector<state_key_t> &path_state_keys, const state_key_t &starting_state_key, const state_key_t &ending_state_key, const int path_length);
+
+	SlidingPuzzleSolver &sps;
+};
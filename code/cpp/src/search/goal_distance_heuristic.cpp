@@ -0,0 +1,121 @@
+#include "goal_distance_heuristic.hpp"
+
+#include "../sliding_puzzle_solver.hpp"
+
+
+void GoalDistanceHeuristic::initialize(void)
+{
+	ending_piece_distances.clear();
+
+	if (sps.options.heuristic == "pdb")
+	{
+		load_pattern_databases();
+	}
+
+	for (const auto &ending_piece : sps.ending_pieces)
+	{
+		if (sps.options.heuristic != "manhattan")
+		{
+			ending_piece_distances.push_back(sps.get_wall_distances(ending_piece));
+			continue;
+		}
+
+		std::vector<int> distances(sps.width * sps.height);
+
+		for (int y = 0; y < sps.height; ++y)
+		{
+			for (int x = 0; x < sps.width; ++x)
+			{
+				distances[x + y * sps.width] = std::abs(x - ending_piece.top_left.x) + std::abs(y - ending_piece.top_left.y);
+			}
+		}
+
+		ending_piece_distances.push_back(distances);
+	}
+}
+
+
+int GoalDistanceHeuristic::get_goal_distance(const pieces_t &pieces)
+{
+	int goal_distance = 0;
+
+	for (std::size_t ending_piece_index = 0; ending_piece_index < ending_piece_distances.size(); ++ending_piece_index)
+	{
+		const Pos &top_left = pieces[sps.ending_pieces[ending_piece_index].piece_index].top_left;
+
+		const int distance = ending_piece_distances[ending_piece_index][top_left.x + top_left.y * sps.width];
+
+		if (distance == -1)
+		{
+			return unreachable;
+		}
+
+		goal_distance += distance;
+	}
+
+	if (pattern_databases.empty())
+	{
+		return goal_distance;
+	}
+
+	int pattern_goal_distance = get_pattern_goal_distance(pieces);
+
+	if (sps.is_mirror_symmetric && pattern_goal_distance != unreachable)
+	{
+		sps.set_mirrored_pieces(mirrored_pieces, pieces);
+
+		pattern_goal_distance = std::max(pattern_goal_distance, get_pattern_goal_distance(mirrored_pieces));
+	}
+
+	return std::max(goal_distance, pattern_goal_distance);
+}
+
+
+int GoalDistanceHeuristic::get_pattern_goal_distance(const pieces_t &pieces)
+{
+	int pattern_goal_distance = 0;
+
+	for (const auto &pattern_database : pattern_databases)
+	{
+		const int distance = pattern_database->get_goal_distance(pieces);
+
+		if (distance == PatternDatabase::unreached)
+		{
+			return unreachable;
+		}
+
+		pattern_goal_distance += distance;
+	}
+
+	return pattern_goal_distance;
+}
+
+
+void GoalDistanceHeuristic::load_pattern_databases(void)
+{
+	if (sps.options.pattern_database_paths.empty())
+	{
+		throw std::runtime_error("The pdb heuristic needs at least one \"--pdb <file>\", made with the pdb_generator tool");
+	}
+
+	std::vector<bool> is_in_pattern(sps.pieces_count, false);
+
+	pattern_databases.clear();
+	mirrored_pieces = sps.get_starting_pieces();
+
+	for (const auto &pattern_database_path : sps.options.pattern_database_paths)
+	{
+		pattern_databases.push_back(std::make_unique<PatternDatabase>(sps));
+		pattern_databases.back()->load(pattern_database_path);
+
+		for (const auto piece_index : pattern_databases.back()->get_pattern_piece_indices())
+		{
+			if (is_in_pattern[piece_index])
+			{
+				throw std::runtime_error("The pattern databases share the piece " + std::string(1, sps.piece_labels[piece_index]) + ", so their goal distances can't be summed");
+			}
+
+			is_in_pattern[piece_index] = true;
+		}
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+#include "../pieces.hpp"
+#include "pattern_database.hpp"
+
+
+#include <climits>
+#include <memory>
+#include <vector>
+
+
+class SlidingPuzzleSolver;
+
+/*
+A lower bound on the number of moves that are left until the goal, which is what lets A* still find a shortest path.
+Every move slides one piece by one cell, so the distances of the ending pieces to their ending positions can be summed.
+
+"manhattan" takes these distances as the crow flies, while "relaxed" lets every ending piece find its way around the walls
+as if it were the only piece on the board, which is never less.
+
+"pdb" sums the goal distances of the loaded pattern databases, and takes "relaxed" instead whenever that's higher.
+Their patterns can't share pieces, as a move of a piece in two patterns would then be counted twice.
+The searches only visit one of a state and its mirror image, so both have to get the same estimate,
+which is why the higher of the two is used.
+*/
+class GoalDistanceHeuristic
+{
+public:
+	GoalDistanceHeuristic(SlidingPuzzleSolver &sps_) : sps(sps_) {};
+	void initialize(void);
+	int get_goal_distance(const pieces_t &pieces);
+
+	// For states in which an ending piece is somewhere it can never reach its ending position from.
+	static int constexpr unreachable = INT_MAX;
+
+private:
+	void load_pattern_databases(void);
+	int get_pattern_goal_distance(const pieces_t &pieces);
+
+	SlidingPuzzleSolver &sps;
+
+	std::vector<std::unique_ptr<PatternDatabase>> pattern_databases;
+
+	pieces_t mirrored_pieces;
+
+	// Indexed by ending piece index and then by cell index, this is -1 where the ending piece can't get to its ending position.
+	std::vector<std::vector<int>> ending_piece_distances;
+};
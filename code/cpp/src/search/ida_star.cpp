@@ -0,0 +1,113 @@
+#include "ida_star.hpp"
+
+#include "../sliding_puzzle_solver.hpp"
+
+
+void IdaStar::solve(void)
+{
+	goal_distance_heuristic.initialize();
+	transposition_table.resize(sps.options.transposition_table_megabytes);
+
+	pieces = sps.get_starting_pieces();
+	sps.set_board_from_pieces(board, pieces);
+
+	const int goal_distance = goal_distance_heuristic.get_goal_distance(pieces);
+
+	bound = goal_distance;
+
+	while (bound != GoalDistanceHeuristic::unreachable)
+	{
+		sps.progress_counters.depth = bound;
+
+		transposition_table.start_iteration();
+
+		const int next_bound = search(0, goal_distance);
+
+		if (next_bound == found)
+		{
+			sps.progress_counters.depth = path.size();
+			sps.path = path;
+			return;
+		}
+
+		bound = next_bound;
+	}
+}
+
+
+int IdaStar::search(const int path_length, const int goal_distance)
+{
+	const int estimated_path_length = path_length + goal_distance;
+
+	if (estimated_path_length > bound)
+	{
+		return estimated_path_length;
+	}
+
+	if (sps.is_goal(pieces))
+	{
+		return found;
+	}
+
+	if (!transposition_table.visit(sps.get_visited_state_key(sps.get_state_key(pieces)), path_length))
+	{
+		return GoalDistanceHeuristic::unreachable;
+	}
+
+	ProgressCounters::Slot &progress = sps.progress_counters.get_slot();
+
+	progress.expanded_state_count++;
+	progress.unique_state_count = transposition_table.get_stored_count();
+
+	// The states on the path are the ones that still have moves left to try.
+	sps.progress_counters.frontier_size = path_length;
+
+	int next_bound = GoalDistanceHeuristic::unreachable;
+
+	for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+	{
+		Pos &piece_top_left = pieces[piece_index].top_left;
+
+		for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+		{
+			// Undoing the previous move can never be part of a shortest path.
+			if (!path.empty() && path.back().first == piece_index && path.back().second == sps.get_inverted_direction(direction))
+			{
+				continue;
+			}
+
+			progress.tested_move_count++;
+
+			if (sps.cant_move(piece_top_left, piece_index, direction, board))
+			{
+				continue;
+			}
+
+			sps.move(piece_top_left, piece_index, direction, board);
+
+			progress.generated_state_count++;
+
+			const int child_goal_distance = goal_distance_heuristic.get_goal_distance(pieces);
+
+			if (child_goal_distance != GoalDistanceHeuristic::unreachable)
+			{
+				path.push_back({piece_index, direction});
+
+				const int child_next_bound = search(path_length + 1, child_goal_distance);
+
+				if (child_next_bound == found)
+				{
+					return found;
+				}
+
+				path.pop_back();
+
+				next_bound = std::min(next_bound, child_next_bound);
+			}
+
+			sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), board);
+		}
+	}
+
+	return next_bound;
+}
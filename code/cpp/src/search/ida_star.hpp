@@ -0,0 +1,47 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+#include "../pieces.hpp"
+#include "../state/transposition_table.hpp"
+#include "goal_distance_heuristic.hpp"
+
+
+#include <vector>
+
+
+class SlidingPuzzleSolver;
+
+/*
+Iterative deepening A*: every iteration is a depth-first search that stops at states whose path length plus estimated goal distance exceeds the bound,
+and the next iteration raises the bound to the smallest estimate that exceeded it.
+The first goal state that is found is therefore at the end of a shortest path.
+
+Apart from the fixed-size TranspositionTable, it only needs memory for the pieces, the board and the moves that lead to the current state,
+which are all moved and undone in place, so puzzles whose states don't all fit in memory can still be solved.
+*/
+class IdaStar
+{
+public:
+	IdaStar(SlidingPuzzleSolver &sps_) : sps(sps_), goal_distance_heuristic(sps_) {};
+	void solve(void);
+
+private:
+	// Returned by search() once the goal has been found.
+	static int constexpr found = -1;
+
+	int search(const int path_length, const int goal_distance);
+
+	SlidingPuzzleSolver &sps;
+
+	GoalDistanceHeuristic goal_distance_heuristic;
+	TranspositionTable transposition_table;
+
+	pieces_t pieces;
+	board_t board;
+
+	// The moves that lead from the starting state to the current one.
+	path_t path;
+
+	int bound;
+};
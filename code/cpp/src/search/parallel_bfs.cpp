@@ -0,0 +1,209 @@
+#include "parallel_bfs.hpp"
+
+#include "../sliding_puzzle_solver.hpp"
+
+
+void ParallelBfs::solve(void)
+{
+	const std::size_t thread_count = sps.options.thread_count;
+
+	discovered_states.resize(thread_count);
+	deferred_states.resize(thread_count);
+	published_state_offsets.resize(thread_count);
+
+	states.reserve(sps.expected_state_count);
+
+	const pieces_t starting_pieces = sps.get_starting_pieces();
+	const state_key_t starting_state_key = sps.get_state_key(starting_pieces);
+
+	states.insert(sps.get_visited_state_key(starting_state_key));
+
+	// The starting state is its own parent, just like in the single-threaded BFS.
+	state_records.push_back({0, 0, 0});
+	frontier.push_back({starting_state_key, 0});
+
+	goal_state_index = sps.is_goal(starting_pieces) ? 0 : no_goal_state_index;
+
+	ProgressCounters &progress_counters = sps.progress_counters;
+
+	while (goal_state_index == no_goal_state_index && !frontier.empty())
+	{
+		progress_counters.frontier_size = frontier.size();
+
+		next_chunk_start = 0;
+		run_on_all_threads(&ParallelBfs::expand_frontier);
+
+		std::size_t deferred_state_count = 0;
+
+		for (const auto &thread_deferred_states : deferred_states)
+		{
+			deferred_state_count += thread_deferred_states.size();
+		}
+
+		if (deferred_state_count > 0)
+		{
+			states.reserve(states.size() + deferred_state_count);
+
+			run_on_all_threads(&ParallelBfs::insert_deferred_states);
+		}
+
+		std::size_t published_state_count = 0;
+
+		for (std::size_t thread_index = 0; thread_index < thread_count; ++thread_index)
+		{
+			published_state_offsets[thread_index] = published_state_count;
+			published_state_count += discovered_states[thread_index].size();
+		}
+
+		first_published_state_index = state_records.size();
+
+		state_records.resize(state_records.size() + published_state_count);
+		next_frontier.resize(published_state_count);
+
+		run_on_all_threads(&ParallelBfs::publish_discovered_states);
+
+		frontier.swap(next_frontier);
+
+		progress_counters.depth++;
+
+		progress_counters.visited_state_set_size = states.size();
+		progress_counters.visited_state_set_capacity = states.capacity();
+	}
+
+	if (goal_state_index != no_goal_state_index)
+	{
+		sps.path = sps.get_path(state_records, goal_state_index);
+	}
+}
+
+
+void ParallelBfs::run_on_all_threads(void (ParallelBfs::*thread_function)(const std::size_t thread_index))
+{
+	std::vector<std::thread> threads;
+
+	// The calling thread does its share of the work as thread 0.
+	for (std::size_t thread_index = 1; thread_index < discovered_states.size(); ++thread_index)
+	{
+		threads.emplace_back(thread_function, this, thread_index);
+	}
+
+	(this->*thread_function)(0);
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+}
+
+
+void ParallelBfs::expand_frontier(const std::size_t thread_index)
+{
+	std::vector<DiscoveredState> &thread_discovered_states = discovered_states[thread_index];
+	thread_discovered_states.clear();
+
+	std::vector<DiscoveredState> &thread_deferred_states = deferred_states[thread_index];
+	thread_deferred_states.clear();
+
+	ProgressCounters::Slot &progress = sps.progress_counters.get_slot(thread_index);
+
+	pieces_t pieces = sps.get_starting_pieces();
+	board_t board;
+
+	const std::size_t frontier_size = frontier.size();
+
+	while (true)
+	{
+		const std::size_t chunk_start = next_chunk_start.fetch_add(chunk_size);
+
+		if (chunk_start >= frontier_size)
+		{
+			break;
+		}
+
+		const std::size_t chunk_end = std::min(chunk_start + chunk_size, frontier_size);
+
+		for (std::size_t frontier_index = chunk_start; frontier_index < chunk_end; ++frontier_index)
+		{
+			const QueuedState &queued_state = frontier[frontier_index];
+
+			sps.set_pieces_from_state_key(pieces, queued_state.state_key);
+			sps.set_board_from_pieces(board, pieces);
+
+			for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+			{
+				Pos &piece_top_left = pieces[piece_index].top_left;
+
+				for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+				{
+					if (sps.cant_move(piece_top_left, piece_index, direction, board))
+					{
+						continue;
+					}
+
+					sps.move(piece_top_left, piece_index, direction, board);
+
+					progress.generated_state_count++;
+
+					const state_key_t state_key = sps.get_state_key(pieces);
+					const StateRecord state_record = {queued_state.state_index, static_cast<uint8_t>(piece_index), static_cast<uint8_t>(direction)};
+
+					if (states.is_full())
+					{
+						thread_deferred_states.push_back({state_key, state_record, sps.is_goal(pieces)});
+					}
+					else if (states.insert(sps.get_visited_state_key(state_key)))
+					{
+						thread_discovered_states.push_back({state_key, state_record, sps.is_goal(pieces)});
+
+						progress.unique_state_count++;
+					}
+
+					sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), board);
+				}
+			}
+
+			progress.tested_move_count += sps.pieces_count * sps.direction_count;
+			progress.expanded_state_count++;
+		}
+	}
+}
+
+
+void ParallelBfs::insert_deferred_states(const std::size_t thread_index)
+{
+	std::vector<DiscoveredState> &thread_discovered_states = discovered_states[thread_index];
+
+	ProgressCounters::Slot &progress = sps.progress_counters.get_slot(thread_index);
+
+	for (const auto &deferred_state : deferred_states[thread_index])
+	{
+		if (states.insert(sps.get_visited_state_key(deferred_state.state_key)))
+		{
+			thread_discovered_states.push_back(deferred_state);
+
+			progress.unique_state_count++;
+		}
+	}
+}
+
+
+void ParallelBfs::publish_discovered_states(const std::size_t thread_index)
+{
+	std::size_t published_index = published_state_offsets[thread_index];
+
+	for (const auto &discovered_state : discovered_states[thread_index])
+	{
+		const uint32_t state_index = first_published_state_index + published_index;
+
+		state_records[state_index] = discovered_state.state_record;
+		next_frontier[published_index] = {discovered_state.state_key, state_index};
+
+		if (discovered_state.is_goal)
+		{
+			uint32_t expected_goal_state_index = no_goal_state_index;
+			goal_state_index.compare_exchange_strong(expected_goal_state_index, state_index);
+		}
+
+		published_index++;
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+#include "../pieces.hpp"
+#include "../state/concurrent_state_set.hpp"
+
+
+#include <atomic>
+#include <vector>
+
+
+class SlidingPuzzleSolver;
+
+/*
+Expands one BFS layer at a time, with every thread taking chunks of the current layer
+and collecting the new states it discovers in its own buffer.
+The buffers are then copied into the next layer in parallel, at offsets known up front.
+
+States that were found while the states set was full are deferred until it has been grown at the end of the layer,
+which is also when it turns out whether they're new.
+*/
+class ParallelBfs
+{
+public:
+	ParallelBfs(SlidingPuzzleSolver &sps_) : sps(sps_) {};
+	void solve(void);
+
+private:
+	static std::size_t constexpr chunk_size = 256;
+	static uint32_t constexpr no_goal_state_index = UINT32_MAX;
+
+	struct DiscoveredState
+	{
+		state_key_t state_key;
+		StateRecord state_record;
+		bool is_goal;
+	};
+
+	void run_on_all_threads(void (ParallelBfs::*thread_function)(const std::size_t thread_index));
+	void expand_frontier(const std::size_t thread_index);
+	void insert_deferred_states(const std::size_t thread_index);
+	void publish_discovered_states(const std::size_t thread_index);
+
+	SlidingPuzzleSolver &sps;
+
+	ConcurrentStateSet states;
+	state_records_t state_records;
+
+	std::vector<QueuedState> frontier;
+	std::vector<QueuedState> next_frontier;
+
+	// Indexed by thread index.
+	std::vector<std::vector<DiscoveredState>> discovered_states;
+	std::vector<std::vector<DiscoveredState>> deferred_states;
+	std::vector<std::size_t> published_state_offsets;
+
+	uint32_t first_published_state_index;
+
+	std::atomic<std::size_t> next_chunk_start;
+	std::atomic<uint32_t> goal_state_index;
+};
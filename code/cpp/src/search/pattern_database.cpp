@@ -0,0 +1,359 @@
+#include "pattern_database.hpp"
+
+#include "../sliding_puzzle_solver.hpp"
+
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+PatternDatabase::~PatternDatabase(void)
+{
+	if (mapping != nullptr)
+	{
+		munmap(mapping, mapping_size);
+	}
+}
+
+
+void PatternDatabase::generate(const std::vector<cell_id> &pattern_piece_indices_, const std::filesystem::path &path)
+{
+	set_pattern(pattern_piece_indices_);
+
+	write(path, get_distances());
+}
+
+
+void PatternDatabase::load(const std::filesystem::path &path)
+{
+	const int fd = open(path.c_str(), O_RDONLY);
+
+	if (fd == -1)
+	{
+		throw std::runtime_error("Couldn't open the pattern database " + path.string());
+	}
+
+	struct stat file_stat;
+
+	if (fstat(fd, &file_stat) == -1)
+	{
+		close(fd);
+		throw std::runtime_error("Couldn't get the size of the pattern database " + path.string());
+	}
+
+	mapping_size = file_stat.st_size;
+
+	if (mapping_size >= sizeof(Header))
+	{
+		mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+
+	close(fd);
+
+	if (mapping == nullptr || mapping == MAP_FAILED)
+	{
+		mapping = nullptr;
+		throw std::runtime_error("Couldn't map the pattern database " + path.string() + " into memory");
+	}
+
+	const Header &header = *static_cast<const Header *>(mapping);
+
+	if (header.magic != magic || header.version != version)
+	{
+		throw std::runtime_error(path.string() + " isn't a pattern database, or one of an older version");
+	}
+
+	if (header.width != static_cast<uint32_t>(sps.width) || header.height != static_cast<uint32_t>(sps.height) || header.pieces_count != static_cast<uint32_t>(sps.pieces_count)
+		|| header.puzzle_fingerprint != sps.get_puzzle_fingerprint())
+	{
+		throw std::runtime_error("The pattern database " + path.string() + " was generated for another puzzle");
+	}
+
+	const uint32_t *pattern_fields = reinterpret_cast<const uint32_t *>(&header + 1);
+
+	const std::size_t distances_offset = sizeof(Header) + 2 * header.pattern_pieces_count * sizeof(uint32_t);
+
+	if (mapping_size != distances_offset + header.pattern_count)
+	{
+		throw std::runtime_error("The pattern database " + path.string() + " is truncated");
+	}
+
+	std::vector<cell_id> header_pattern_piece_indices;
+
+	for (uint32_t pattern_piece_index = 0; pattern_piece_index < header.pattern_pieces_count; ++pattern_piece_index)
+	{
+		const uint32_t piece_index = pattern_fields[pattern_piece_index];
+
+		if (piece_index >= header.pieces_count)
+		{
+			throw std::runtime_error("The pattern database " + path.string() + " has a piece index that's out of range");
+		}
+
+		header_pattern_piece_indices.push_back(piece_index);
+	}
+
+	set_pattern(header_pattern_piece_indices);
+
+	// The walls or piece shapes differing would change the radices, as different top-lefts would fit.
+	for (uint32_t pattern_piece_index = 0; pattern_piece_index < header.pattern_pieces_count; ++pattern_piece_index)
+	{
+		if (pattern_fields[header.pattern_pieces_count + pattern_piece_index] != wall_free_cell_indices[pattern_piece_index].size())
+		{
+			throw std::runtime_error("The pattern database " + path.string() + " was generated for another puzzle");
+		}
+	}
+
+	distances = static_cast<const uint8_t *>(mapping) + distances_offset;
+}
+
+
+int PatternDatabase::get_goal_distance(const pieces_t &pieces) const
+{
+	return distances[get_pattern_index(pieces)];
+}
+
+
+const std::vector<cell_id> &PatternDatabase::get_pattern_piece_indices(void) const
+{
+	return pattern_piece_indices;
+}
+
+
+uint64_t PatternDatabase::get_pattern_count(void) const
+{
+	return pattern_count;
+}
+
+
+void PatternDatabase::set_pattern(const std::vector<cell_id> &pattern_piece_indices_)
+{
+	pattern_piece_indices = pattern_piece_indices_;
+
+	for (const auto &identical_pieces : sps.identical_piece_classes)
+	{
+		const std::size_t pattern_identical_piece_count = std::count_if(identical_pieces.cbegin(), identical_pieces.cend(), [&](const cell_id piece_index) {
+			return std::find(pattern_piece_indices.cbegin(), pattern_piece_indices.cend(), piece_index) != pattern_piece_indices.cend();
+		});
+
+		if (pattern_identical_piece_count != 0 && pattern_identical_piece_count != identical_pieces.size())
+		{
+			throw std::runtime_error("The pattern has to have either all or none of the pieces that are identical to " + std::string(1, sps.piece_labels[identical_pieces[0]]));
+		}
+	}
+
+	wall_free_cell_indices.clear();
+	digits.clear();
+	place_values.clear();
+
+	pattern_count = 1;
+
+	for (const auto piece_index : pattern_piece_indices)
+	{
+		const std::vector<int> piece_wall_free_cell_indices = sps.get_wall_free_cell_indices(piece_index);
+
+		std::vector<int> piece_digits(sps.width * sps.height, -1);
+
+		for (std::size_t digit = 0; digit < piece_wall_free_cell_indices.size(); ++digit)
+		{
+			piece_digits[piece_wall_free_cell_indices[digit]] = digit;
+		}
+
+		wall_free_cell_indices.push_back(piece_wall_free_cell_indices);
+		digits.push_back(piece_digits);
+		place_values.push_back(pattern_count);
+
+		pattern_count *= piece_wall_free_cell_indices.size();
+
+		if (pattern_count > max_pattern_count)
+		{
+			throw std::runtime_error("The pattern has more than " + std::to_string(max_pattern_count) + " placements, so leave some pieces out of it");
+		}
+	}
+}
+
+
+uint64_t PatternDatabase::get_pattern_index(const pieces_t &pieces) const
+{
+	uint64_t pattern_index = 0;
+
+	for (std::size_t pattern_piece_index = 0; pattern_piece_index < pattern_piece_indices.size(); ++pattern_piece_index)
+	{
+		const Pos &top_left = pieces[pattern_piece_indices[pattern_piece_index]].top_left;
+
+		pattern_index += digits[pattern_piece_index][top_left.x + top_left.y * sps.width] * place_values[pattern_piece_index];
+	}
+
+	return pattern_index;
+}
+
+
+void PatternDatabase::set_pattern_pieces(pieces_t &pieces, uint64_t pattern_index) const
+{
+	for (std::size_t pattern_piece_index = 0; pattern_piece_index < pattern_piece_indices.size(); ++pattern_piece_index)
+	{
+		const std::vector<int> &piece_wall_free_cell_indices = wall_free_cell_indices[pattern_piece_index];
+
+		const int cell_index = piece_wall_free_cell_indices[pattern_index % piece_wall_free_cell_indices.size()];
+		pattern_index /= piece_wall_free_cell_indices.size();
+
+		Pos &top_left = pieces[pattern_piece_indices[pattern_piece_index]].top_left;
+		top_left.x = cell_index % sps.width;
+		top_left.y = cell_index / sps.width;
+	}
+}
+
+
+bool PatternDatabase::are_pattern_pieces_overlapping(const pieces_t &pieces) const
+{
+	std::vector<bool> is_taken(sps.width * sps.height, false);
+
+	for (const auto piece_index : pattern_piece_indices)
+	{
+		const Pos &top_left = pieces[piece_index].top_left;
+
+		for (const auto &rect : sps.starting_pieces_info[piece_index].rects)
+		{
+			for (int y = top_left.y + rect.offset.y; y < top_left.y + rect.offset.y + rect.size.height; ++y)
+			{
+				for (int x = top_left.x + rect.offset.x; x < top_left.x + rect.offset.x + rect.size.width; ++x)
+				{
+					if (is_taken[x + y * sps.width])
+					{
+						return true;
+					}
+
+					is_taken[x + y * sps.width] = true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+
+// Ending pieces that aren't in the pattern are off the board, so they can't stop it from being a goal.
+bool PatternDatabase::is_pattern_goal(const pieces_t &pieces) const
+{
+	for (const auto &ending_piece : sps.ending_pieces)
+	{
+		const cell_id piece_index = ending_piece.piece_index;
+
+		if (std::find(pattern_piece_indices.cbegin(), pattern_piece_indices.cend(), piece_index) != pattern_piece_indices.cend() && !(pieces[piece_index].top_left == ending_piece.top_left))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+std::vector<uint8_t> PatternDatabase::get_distances(void)
+{
+	std::vector<uint8_t> new_distances(pattern_count, unreached);
+
+	pieces_t pieces = sps.get_starting_pieces();
+	board_t board;
+
+	std::vector<uint32_t> frontier;
+	std::vector<uint32_t> next_frontier;
+
+	for (uint64_t pattern_index = 0; pattern_index < pattern_count; ++pattern_index)
+	{
+		set_pattern_pieces(pieces, pattern_index);
+
+		if (!are_pattern_pieces_overlapping(pieces) && is_pattern_goal(pieces))
+		{
+			new_distances[pattern_index] = 0;
+			frontier.push_back(pattern_index);
+		}
+	}
+
+	// Moves can be undone, so searching forward from the goals finds the distances back to them.
+	for (int distance = 1; !frontier.empty(); ++distance)
+	{
+		// Capping the distance keeps it a lower bound, while unreached stays free to mean unreachable.
+		const uint8_t stored_distance = std::min(distance, unreached - 1);
+
+		for (const auto pattern_index : frontier)
+		{
+			set_pattern_pieces(pieces, pattern_index);
+			sps.set_board_from_pattern_pieces(board, pieces, pattern_piece_indices);
+
+			for (const auto piece_index : pattern_piece_indices)
+			{
+				Pos &piece_top_left = pieces[piece_index].top_left;
+
+				for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+				{
+					if (sps.cant_move(piece_top_left, piece_index, direction, board))
+					{
+						continue;
+					}
+
+					sps.move(piece_top_left, piece_index, direction, board);
+
+					const uint64_t next_pattern_index = get_pattern_index(pieces);
+
+					if (new_distances[next_pattern_index] == unreached)
+					{
+						new_distances[next_pattern_index] = stored_distance;
+						next_frontier.push_back(next_pattern_index);
+					}
+
+					sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), board);
+				}
+			}
+		}
+
+		frontier.swap(next_frontier);
+		next_frontier.clear();
+	}
+
+	return new_distances;
+}
+
+
+void PatternDatabase::write(const std::filesystem::path &path, const std::vector<uint8_t> &distances_to_write)
+{
+	std::ofstream stream(path, std::ios::binary);
+
+	if (!stream)
+	{
+		throw std::runtime_error("Couldn't create the pattern database " + path.string());
+	}
+
+	Header header = {};
+	header.magic = magic;
+	header.version = version;
+	header.width = sps.width;
+	header.height = sps.height;
+	header.pieces_count = sps.pieces_count;
+	header.pattern_pieces_count = pattern_piece_indices.size();
+	header.pattern_count = pattern_count;
+	header.puzzle_fingerprint = sps.get_puzzle_fingerprint();
+
+	stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+	for (const auto piece_index : pattern_piece_indices)
+	{
+		const uint32_t field = piece_index;
+		stream.write(reinterpret_cast<const char *>(&field), sizeof(field));
+	}
+
+	for (const auto &piece_wall_free_cell_indices : wall_free_cell_indices)
+	{
+		const uint32_t field = piece_wall_free_cell_indices.size();
+		stream.write(reinterpret_cast<const char *>(&field), sizeof(field));
+	}
+
+	stream.write(reinterpret_cast<const char *>(distances_to_write.data()), distances_to_write.size());
+
+	if (!stream)
+	{
+		throw std::runtime_error("Couldn't write the pattern database " + path.string());
+	}
+}
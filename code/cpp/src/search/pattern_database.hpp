@@ -0,0 +1,100 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+#include "../pieces.hpp"
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+
+class SlidingPuzzleSolver;
+
+/*
+The number of moves a few pattern pieces need to reach the goal when every other piece is taken off the board,
+which never overshoots the number of moves the real puzzle needs.
+The table is written once by the pdb_generator tool, which does a backward BFS from every goal placement of the pattern pieces.
+
+The table is indexed by a mixed-radix number, where the digit of every pattern piece is the index of its top-left
+among the top-lefts where it fits between the walls, so no entries are wasted on pieces sticking into walls.
+A pattern holds either all or none of the pieces of every identical piece class,
+so that swapping identical pieces, which the searches treat as the same state, doesn't change the estimate.
+The solver maps the file into memory instead of reading it, so tables bigger than the free memory still work.
+*/
+class PatternDatabase
+{
+public:
+	PatternDatabase(SlidingPuzzleSolver &sps_) : sps(sps_) {};
+	~PatternDatabase(void);
+
+	PatternDatabase(const PatternDatabase &) = delete;
+	PatternDatabase &operator=(const PatternDatabase &) = delete;
+
+	void generate(const std::vector<cell_id> &pattern_piece_indices, const std::filesystem::path &path);
+	void load(const std::filesystem::path &path);
+
+	// Returns unreached for placements the goal can't be reached from.
+	int get_goal_distance(const pieces_t &pieces) const;
+
+	const std::vector<cell_id> &get_pattern_piece_indices(void) const;
+	uint64_t get_pattern_count(void) const;
+
+	static uint8_t constexpr unreached = UINT8_MAX;
+
+private:
+	struct Header
+	{
+		std::array<char, 8> magic;
+		uint32_t version;
+		uint32_t width;
+		uint32_t height;
+		uint32_t pieces_count;
+		uint32_t pattern_pieces_count;
+		uint32_t padding;
+		uint64_t pattern_count;
+
+		// Covers the goal, walls and piece shapes, which the sizes above don't.
+		uint64_t puzzle_fingerprint;
+
+		// Followed by the pattern piece indices and radices as uint32_t, and then a uint8_t distance for every pattern index.
+	};
+
+	static std::array<char, 8> constexpr magic = {'S', 'P', 'P', 'D', 'B', '\0', '\0', '\0'};
+	static uint32_t constexpr version = 2;
+
+	// The backward BFS queues pattern indices as uint32_t.
+	static uint64_t constexpr max_pattern_count = UINT32_MAX;
+
+	void set_pattern(const std::vector<cell_id> &pattern_piece_indices);
+	uint64_t get_pattern_index(const pieces_t &pieces) const;
+	void set_pattern_pieces(pieces_t &pieces, uint64_t pattern_index) const;
+	bool are_pattern_pieces_overlapping(const pieces_t &pieces) const;
+	bool is_pattern_goal(const pieces_t &pieces) const;
+
+	std::vector<uint8_t> get_distances(void);
+	void write(const std::filesystem::path &path, const std::vector<uint8_t> &distances_to_write);
+
+	SlidingPuzzleSolver &sps;
+
+	std::vector<cell_id> pattern_piece_indices;
+
+	// Indexed by pattern piece index, these are the cell indices where the piece fits between the walls.
+	std::vector<std::vector<int>> wall_free_cell_indices;
+
+	// Indexed by pattern piece index and then by cell index, this is the digit of the piece's top-left, or -1 where it doesn't fit.
+	std::vector<std::vector<int>> digits;
+
+	// Indexed by pattern piece index.
+	std::vector<uint64_t> place_values;
+
+	uint64_t pattern_count = 0;
+
+	void *mapping = nullptr;
+	std::size_t mapping_size = 0;
+
+	const uint8_t *distances = nullptr;
+};
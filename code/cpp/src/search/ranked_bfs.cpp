@@ -0,0 +1,205 @@
+#include "ranked_bfs.hpp"
+
+#include "../sliding_puzzle_solver.hpp"
+
+
+void RankedBfs::solve(void)
+{
+	if (sps.pieces_count * sps.direction_count >= starting_undo_move)
+	{
+		throw std::invalid_argument("The ranked BFS stores moves in a byte, which can't hold this many pieces");
+	}
+
+	state_ranker.initialize();
+
+	const uint64_t state_count = state_ranker.get_state_count();
+
+	visited_bits.assign((state_count + 63) / 64, 0);
+	undo_moves.assign(state_count, 0);
+
+	pieces_t pieces = sps.get_starting_pieces();
+	pieces_t mirrored_pieces = pieces;
+
+	bool is_mirrored;
+	const uint64_t starting_rank = state_ranker.get_visited_rank(pieces, mirrored_pieces, is_mirrored);
+
+	visit(starting_rank);
+	undo_moves[starting_rank] = starting_undo_move;
+	layer.push_back(starting_rank);
+
+	ProgressCounters &progress_counters = sps.progress_counters;
+	progress_counters.get_slot().unique_state_count = 1;
+
+	while (!layer.empty())
+	{
+		progress_counters.frontier_size = layer.size();
+
+		uint64_t goal_rank;
+
+		if (expand_layer(goal_rank))
+		{
+			sps.path = get_path(goal_rank);
+			return;
+		}
+
+		layer.swap(next_layer);
+		next_layer.clear();
+
+		if (!layer.empty())
+		{
+			progress_counters.depth++;
+		}
+	}
+}
+
+
+// Returns whether the rank wasn't visited yet.
+bool RankedBfs::visit(const uint64_t rank)
+{
+	uint64_t &word = visited_bits[rank / 64];
+	const uint64_t bit = uint64_t(1) << (rank % 64);
+
+	if (word & bit)
+	{
+		return false;
+	}
+
+	word |= bit;
+
+	return true;
+}
+
+
+// Stops at the first goal state of the layer, and returns whether there was one.
+bool RankedBfs::expand_layer(uint64_t &goal_rank)
+{
+	pieces_t pieces = sps.get_starting_pieces();
+	pieces_t mirrored_pieces = pieces;
+	board_t board;
+
+	ProgressCounters::Slot &progress = sps.progress_counters.get_slot();
+
+	for (const auto rank : layer)
+	{
+		state_ranker.set_pieces_from_rank(pieces, rank);
+
+		if (sps.is_goal(pieces))
+		{
+			goal_rank = rank;
+			return true;
+		}
+
+		sps.set_board_from_pieces(board, pieces);
+
+		for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+		{
+			Pos &piece_top_left = pieces[piece_index].top_left;
+
+			for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+			{
+				if (sps.cant_move(piece_top_left, piece_index, direction, board))
+				{
+					continue;
+				}
+
+				sps.move(piece_top_left, piece_index, direction, board);
+
+				progress.generated_state_count++;
+
+				bool is_mirrored;
+				const uint64_t next_rank = state_ranker.get_visited_rank(pieces, mirrored_pieces, is_mirrored);
+
+				if (visit(next_rank))
+				{
+					undo_moves[next_rank] = get_undo_move(is_mirrored ? mirrored_pieces : pieces, piece_index, direction, is_mirrored);
+					next_layer.push_back(next_rank);
+
+					progress.unique_state_count++;
+				}
+
+				sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), board);
+			}
+		}
+
+		progress.tested_move_count += sps.pieces_count * sps.direction_count;
+		progress.expanded_state_count++;
+	}
+
+	return false;
+}
+
+
+/*
+The move has to be stored in terms of the pieces that the rank turns back into,
+whose identical pieces are in increasing cell order, and which are mirrored if the mirror image had the lower rank.
+*/
+uint8_t RankedBfs::get_undo_move(const pieces_t &visited_pieces, const cell_id piece_index, const piece_direction direction, const bool is_mirrored)
+{
+	const Pos &moved_top_left = visited_pieces[piece_index].top_left;
+	const int moved_cell_index = moved_top_left.x + moved_top_left.y * sps.width;
+
+	const auto &class_piece_indices = state_ranker.class_piece_indices[state_ranker.piece_class_indices[piece_index]];
+
+	std::size_t earlier_piece_count = 0;
+
+	for (const auto class_piece_index : class_piece_indices)
+	{
+		const Pos &top_left = visited_pieces[class_piece_index].top_left;
+
+		if (top_left.x + top_left.y * sps.width < moved_cell_index)
+		{
+			earlier_piece_count++;
+		}
+	}
+
+	const cell_id undo_piece_index = class_piece_indices[earlier_piece_count];
+
+	piece_direction undo_direction = sps.get_inverted_direction(direction);
+
+	// Mirroring swaps the left and right directions.
+	if (is_mirrored && sps.direction_characters[undo_direction] == '<')
+	{
+		undo_direction++;
+	}
+	else if (is_mirrored && sps.direction_characters[undo_direction] == '>')
+	{
+		undo_direction--;
+	}
+
+	return undo_piece_index * sps.direction_count + undo_direction;
+}
+
+
+path_t RankedBfs::get_path(uint64_t rank)
+{
+	std::vector<state_key_t> visited_state_keys;
+
+	pieces_t pieces = sps.get_starting_pieces();
+	pieces_t mirrored_pieces = pieces;
+	board_t board;
+
+	while (true)
+	{
+		state_ranker.set_pieces_from_rank(pieces, rank);
+		visited_state_keys.push_back(sps.get_visited_state_key(sps.get_state_key(pieces)));
+
+		const uint8_t undo_move = undo_moves[rank];
+
+		if (undo_move == starting_undo_move)
+		{
+			break;
+		}
+
+		const cell_id piece_index = undo_move / sps.direction_count;
+
+		sps.set_board_from_pieces(board, pieces);
+		sps.move(pieces[piece_index].top_left, piece_index, undo_move % sps.direction_count, board);
+
+		bool is_mirrored;
+		rank = state_ranker.get_visited_rank(pieces, mirrored_pieces, is_mirrored);
+	}
+
+	std::reverse(visited_state_keys.begin(), visited_state_keys.end());
+
+	return sps.get_path_through_visited_state_keys(visited_state_keys);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+#include "../pieces.hpp"
+#include "../state/state_ranker.hpp"
+
+
+#include <vector>
+#include <cstdint>
+
+
+class SlidingPuzzleSolver;
+
+/*
+The BFS, but with every state known by its rank instead of its state key.
+The visited states are a bit array and the layers hold ranks, so nothing is hashed,
+and the only other thing stored for every placement is a byte with the move that leads back to the state it was reached from.
+
+This needs memory for every placement of the pieces, whether it can be reached or not,
+so it pays off for puzzles that can reach a good share of them.
+*/
+class RankedBfs
+{
+public:
+	RankedBfs(SlidingPuzzleSolver &sps_) : sps(sps_), state_ranker(sps_) {};
+	void solve(void);
+
+private:
+	// The starting state isn't reached by any move.
+	static uint8_t const starting_undo_move = 255;
+
+	bool visit(const uint64_t rank);
+
+	bool expand_layer(uint64_t &goal_rank);
+	uint8_t get_undo_move(const pieces_t &visited_pieces, const cell_id piece_index, const piece_direction direction, const bool is_mirrored);
+
+	path_t get_path(uint64_t rank);
+
+	SlidingPuzzleSolver &sps;
+
+	StateRanker state_ranker;
+
+	std::vector<uint64_t> visited_bits;
+
+	// Indexed by rank, this is the piece index times the direction count plus the direction
+	// that moves the pieces of the rank back to the state it was reached from.
+	std::vector<uint8_t> undo_moves;
+
+	std::vector<uint64_t> layer;
+	std::vector<uint64_t> next_layer;
+};
@@ -5,18 +5,22 @@
 #include "printer/timed_printer.hpp"
 
 
-SlidingPuzzleSolver::SlidingPuzzleSolver(std::filesystem::path &exe_path, const std::string &puzzle_name)
-	: board_printer(*this), timed_printer(*this)
+SlidingPuzzleSolver::SlidingPuzzleSolver(std::filesystem::path &exe_path, const Options &options)
+	: options(options), progress_counters(options.thread_count), metrics_writer(*this), board_printer(*this), timed_printer(*this), parallel_bfs(*this), bidirectional_bfs(*this), a_star(*this), ida_star(*this), enumeration(*this), distance_database(*this), ranked_bfs(*this), external_bfs(*this), frontier_search(*this), bfs_checkpoint(*this)
 {
 	// board_printer = BoardPrinter(&this);
 
-	const json puzzle_json = get_puzzle_json(exe_path, puzzle_name);
+	const json puzzle_json = get_puzzle_json(exe_path, options.puzzle_name);
 
 	set_constant_fields(puzzle_json);
 	initialize_variable_fields(puzzle_json);
 
 	set_emptied_offsets();
 	set_collision_offsets();
+
+	set_mirror_symmetry();
+
+	set_bitboard_moves();
 }
 
 
@@ -55,10 +59,16 @@ void SlidingPuzzleSolver::set_constant_fields(const json &puzzle_json)
 
 	set_ending_pieces(puzzle_json["starting_pieces_info"]);
 
+	set_identical_piece_classes();
+
 	set_walls(puzzle_json["walls"]);
 	set_width_and_height();
 
+	set_state_key_layout();
+
 	set_starting_cells();
+
+	reserve_states(puzzle_json);
 }
 
 
@@ -125,6 +135,71 @@ void SlidingPuzzleSolver::set_ending_pieces(const json &starting_pieces_json)
 }
 
 
+void SlidingPuzzleSolver::set_identical_piece_classes(void)
+{
+	std::vector<bool> is_classified(pieces_count, false);
+
+	previous_identical_piece_indices.assign(pieces_count, -1);
+
+	for (cell_id piece_index = 0; piece_index != pieces_count; ++piece_index)
+	{
+		if (is_classified[piece_index] || is_ending_piece(piece_index))
+		{
+			continue;
+		}
+
+		std::vector<cell_id> identical_pieces = {piece_index};
+
+		for (cell_id other_piece_index = piece_index + 1; other_piece_index != pieces_count; ++other_piece_index)
+		{
+			if (is_classified[other_piece_index] || is_ending_piece(other_piece_index))
+			{
+				continue;
+			}
+
+			if (starting_pieces_info[other_piece_index].rects == starting_pieces_info[piece_index].rects)
+			{
+				previous_identical_piece_indices[other_piece_index] = identical_pieces.back();
+
+				identical_pieces.push_back(other_piece_index);
+				is_classified[other_piece_index] = true;
+			}
+		}
+
+		if (identical_pieces.size() > 1)
+		{
+			identical_piece_classes.push_back(identical_pieces);
+		}
+	}
+}
+
+
+bool SlidingPuzzleSolver::is_ending_piece(const cell_id piece_index)
+{
+	for (const auto &ending_piece : ending_pieces)
+	{
+		if (static_cast<cell_id>(ending_piece.piece_index) == piece_index)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+void SlidingPuzzleSolver::reserve_states(const json &puzzle_json)
+{
+	// The optional "expected_state_count" hint lets big puzzles skip all the rehashing while the states set grows.
+	if (puzzle_json.contains("expected_state_count"))
+	{
+		expected_state_count = puzzle_json["expected_state_count"];
+
+		states.reserve(expected_state_count);
+	}
+}
+
+
 void SlidingPuzzleSolver::set_walls(const json &walls_json)
 {
 	for (const auto &wall_json : walls_json)
@@ -170,6 +245,27 @@ void SlidingPuzzleSolver::set_width_and_height(void)
 }
 
 
+void SlidingPuzzleSolver::set_state_key_layout(void)
+{
+	const int largest_cell_index = width * height - 1;
+
+	bits_per_piece = 1;
+	while ((1 << bits_per_piece) <= largest_cell_index)
+	{
+		bits_per_piece++;
+	}
+
+	pieces_per_state_key_word = state_key_word_bits / bits_per_piece;
+
+	const int needed_state_key_words = (pieces_count + pieces_per_state_key_word - 1) / pieces_per_state_key_word;
+
+	if (needed_state_key_words > static_cast<int>(state_key_words))
+	{
+		throw std::runtime_error("This puzzle needs " + std::to_string(needed_state_key_words) + " state key words, so rebuild with \"make re STATE_KEY_WORDS=" + std::to_string(needed_state_key_words) + "\"");
+	}
+}
+
+
 void SlidingPuzzleSolver::set_starting_cells(void)
 {
 	// The program assumes that unspecified cells are empty cells by default
@@ -331,285 +427,1171 @@ piece_direction SlidingPuzzleSolver::get_inverted_direction(const piece_directio
 }
 
 
-void SlidingPuzzleSolver::initialize_variable_fields(const json &puzzle_json)
+void SlidingPuzzleSolver::set_mirror_symmetry(void)
 {
-	add_wall_cells(puzzle_json["walls"]);
-	add_piece_cells();
-}
+	is_mirror_symmetric = are_walls_mirror_symmetric();
 
-
-void SlidingPuzzleSolver::add_wall_cells(const json &walls_json)
-{
-	for (const auto &wall_json : walls_json)
+	for (cell_id piece_index = 0; piece_index != pieces_count; ++piece_index)
 	{
-		Wall wall;
-
-		const json &wall_pos_json = wall_json["pos"];
-		wall.pos.x = wall_pos_json["x"];
-		wall.pos.y = wall_pos_json["y"];
+		if (!is_piece_mirror_symmetric(piece_index))
+		{
+			is_mirror_symmetric = false;
+		}
+	}
 
-		const json &wall_size_json = wall_json["size"];
-		wall.size.width = wall_size_json["width"];
-		wall.size.height = wall_size_json["height"];
+	for (const auto &ending_piece : ending_pieces)
+	{
+		const Pos &ending_piece_top_left = ending_piece.top_left;
 
-		for (int y_offset = 0; y_offset < wall.size.height; ++y_offset)
+		if (get_mirrored_x_sum(ending_piece.piece_index) - ending_piece_top_left.x != ending_piece_top_left.x)
 		{
-			for (int x_offset = 0; x_offset < wall.size.width; ++x_offset)
-			{
-				starting_cells[wall.pos.y + y_offset][wall.pos.x + x_offset] = wall_cell_id;
-			}
+			is_mirror_symmetric = false;
 		}
 	}
-}
-
 
-void SlidingPuzzleSolver::add_piece_cells(void)
-{
-	for (cell_id starting_piece_info_index = 0; starting_piece_info_index != pieces_count; ++starting_piece_info_index)
+	if (!is_mirror_symmetric)
 	{
-		const StartingPieceInfo &starting_piece_info = starting_pieces_info[starting_piece_info_index];
-		const Pos &top_left = starting_piece_info.top_left;
+		return;
+	}
 
-		const std::vector<Rect> &rects = starting_piece_info.rects;
-		for (const auto &rect : rects)
-		{
-			const Offset &rect_offset = rect.offset;
+	mirrored_cell_indices.resize(pieces_count);
 
-			const int rect_top_left_x = top_left.x + rect_offset.x;
-			const int rect_top_left_y = top_left.y + rect_offset.y;
+	for (cell_id piece_index = 0; piece_index != pieces_count; ++piece_index)
+	{
+		const int mirrored_x_sum = get_mirrored_x_sum(piece_index);
 
-			const Size &rect_size = rect.size;
+		std::vector<uint64_t> &piece_mirrored_cell_indices = mirrored_cell_indices[piece_index];
+		piece_mirrored_cell_indices.resize(width * height);
 
-			for (int y_offset = 0; y_offset < rect_size.height; ++y_offset)
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
 			{
-				for (int x_offset = 0; x_offset < rect_size.width; ++x_offset)
+				const int mirrored_x = mirrored_x_sum - x;
+
+				// Such top-lefts would put the piece outside of the board, so they can't be reached.
+				if (mirrored_x < 0 || mirrored_x >= width)
 				{
-					starting_cells[rect_top_left_y + y_offset][rect_top_left_x + x_offset] = starting_piece_info_index;
+					continue;
 				}
+
+				piece_mirrored_cell_indices[x + y * width] = mirrored_x + y * width;
 			}
 		}
 	}
 }
 
 
-pieces_t SlidingPuzzleSolver::get_starting_pieces(void)
+bool SlidingPuzzleSolver::are_walls_mirror_symmetric(void)
 {
-	pieces_t starting_pieces;
-
-	for (const auto &starting_piece_info : starting_pieces_info)
+	for (int y = 0; y < height; ++y)
 	{
-		Piece piece;
-
-		piece.top_left = starting_piece_info.top_left;
+		for (int x = 0; x < width; ++x)
+		{
+			const bool is_wall = wall_cells[y][x] == wall_cell_id;
+			const bool is_mirrored_wall = wall_cells[y][width - 1 - x] == wall_cell_id;
 
-		starting_pieces.push_back(piece);
+			if (is_wall != is_mirrored_wall)
+			{
+				return false;
+			}
+		}
 	}
 
-	return starting_pieces;
+	return true;
 }
 
 
-bool SlidingPuzzleSolver::add_state(const pieces_t &pieces)
+int SlidingPuzzleSolver::get_mirrored_x_sum(const cell_id piece_index)
 {
-	const std::pair<std::unordered_set<pieces_t, Piece::HashFunction>::iterator, bool> insert_info = states.insert(pieces);
+	/*
+	A piece spanning the x offsets "left" up to and including "right" relative to its top-left x
+	covers the mirrored board columns "width - 1 - x - right" up to "width - 1 - x - left",
+	so its mirrored top-left x is this sum minus its top-left x.
+	*/
+	const std::vector<Rect> &rects = starting_pieces_info[piece_index].rects;
 
-	const bool success = insert_info.second;
+	int left = rects[0].offset.x;
+	int right = rects[0].offset.x + rects[0].size.width - 1;
 
-	return success;
+	for (const auto &rect : rects)
+	{
+		left = std::min(left, rect.offset.x);
+		right = std::max(right, rect.offset.x + rect.size.width - 1);
+	}
+
+	return width - 1 - left - right;
 }
 
 
-void SlidingPuzzleSolver::solve(void)
+bool SlidingPuzzleSolver::is_piece_mirror_symmetric(const cell_id piece_index)
 {
-	const auto starting_pieces = get_starting_pieces();
+	const std::vector<Rect> &rects = starting_pieces_info[piece_index].rects;
 
-	board_printer.print_board(starting_pieces);
+	std::vector<Offset> offsets;
+	std::vector<Offset> mirrored_offsets;
 
-	add_state(starting_pieces);
+	// Mirroring an offset within the piece's own columns turns x into "left + right - x".
+	const int mirrored_x_sum = (width - 1) - get_mirrored_x_sum(piece_index);
 
-	pieces_queue_t pieces_queue;
-
-	pieces_queue.push({starting_pieces, starting_cells});
-
-	path_queue_t path_queue;
-	const path_t initial_empty_path = std::vector<std::pair<cell_id, piece_direction>>();
-	path_queue.push(initial_empty_path);
-
-	// TODO: Can this line be shortened?
-	std::thread timed_print_thread(&TimedPrinter::timed_print, this, std::ref(pieces_queue), std::ref(path_queue));
-
-	while (!pieces_queue.empty())
+	for (const auto &rect : rects)
 	{
-		auto [pieces, cells] = pieces_queue.front();
-		pieces_queue.pop();
+		for (int y_offset = 0; y_offset < rect.size.height; ++y_offset)
+		{
+			for (int x_offset = 0; x_offset < rect.size.width; ++x_offset)
+			{
+				const int x = rect.offset.x + x_offset;
+				const int y = rect.offset.y + y_offset;
 
-		// print_board(pieces);
-		// std::cout << std::endl;
+				offsets.push_back({x, y});
+				mirrored_offsets.push_back({mirrored_x_sum - x, y});
+			}
+		}
+	}
 
-		update_finished(pieces);
-		if (finished)
+	for (const auto &mirrored_offset : mirrored_offsets)
+	{
+		if (std::find(offsets.cbegin(), offsets.cend(), mirrored_offset) == offsets.cend())
 		{
-			break;
+			return false;
 		}
-
-		const path_t path = path_queue.front();
-		path_queue.pop(); // Purposely placed *after* the break above, as timed_print() is responsible for printing the final path.
-
-		queue_valid_moves(pieces_queue, pieces, cells, path_queue, path);
 	}
 
-	timed_print_thread.join();
+	return true;
 }
 
 
-void SlidingPuzzleSolver::update_finished(const pieces_t &pieces)
+void SlidingPuzzleSolver::set_bitboard_moves(void)
 {
-	finished = true;
+	const int cell_count = width * height;
 
-	for (const auto &ending_piece : ending_pieces)
+	if (cell_count > static_cast<int>(bitboard_words * bitboard_word_bits))
 	{
-		const cell_id ending_piece_index = ending_piece.piece_index;
-		const Pos &ending_piece_top_left = ending_piece.top_left;
+#ifndef CELLS_MOVE_ENGINE
+		const int needed_bitboard_words = (cell_count + bitboard_word_bits - 1) / bitboard_word_bits;
 
-		const Piece &piece = pieces[ending_piece_index];
-		const Pos &piece_top_left = piece.top_left;
+		throw std::runtime_error("This puzzle needs " + std::to_string(needed_bitboard_words) + " bitboard words, so rebuild with \"make re BITBOARD_WORDS=" + std::to_string(needed_bitboard_words) + "\"");
+#else
+		return;
+#endif
+	}
 
-		// TODO: Use a friend declared operator != to do pos comparison instead?
-		if (ending_piece_top_left.x != piece_top_left.x || ending_piece_top_left.y != piece_top_left.y)
+	wall_bitboard = {};
+
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
 		{
-			finished = false;
-			return;
+			if (wall_cells[y][x] == wall_cell_id)
+			{
+				wall_bitboard.set(x + y * width);
+			}
 		}
 	}
-}
 
+	bitboard_moves.resize(pieces_count * direction_count * cell_count);
 
-void SlidingPuzzleSolver::queue_valid_moves(pieces_queue_t &pieces_queue, pieces_t &pieces, cells_t &cells, path_queue_t &path_queue, const path_t &path)
-{
-	for (cell_id piece_index = 0; piece_index != pieces_count; ++piece_index)
+	for (cell_id piece_index = 0; piece_index < pieces_count; ++piece_index)
 	{
-		Piece &piece = pieces[piece_index];
-		Pos &piece_top_left = piece.top_left;
-
-		for (piece_direction direction = 0; direction < direction_count; ++direction)
+		for (int y = 0; y < height; ++y)
 		{
-			if (cant_move(piece_top_left, piece_index, direction, cells))
+			for (int x = 0; x < width; ++x)
 			{
-				continue;
-			}
+				const Pos piece_top_left = {x, y};
 
-			move(piece_top_left, piece_index, direction, cells);
+				// Top-lefts where the piece sticks out of the board can never be reached, so their masks stay empty.
+				if (!is_piece_in_bounds(piece_index, piece_top_left))
+				{
+					continue;
+				}
 
-			if (add_state(pieces))
-			{
-				pieces_queue.push({get_pieces_copy(pieces), get_cells_copy(cells)});
+				const Bitboard piece_bitboard = get_piece_bitboard(piece_index, piece_top_left);
+
+				for (piece_direction direction = 0; direction < direction_count; ++direction)
+				{
+					BitboardMove &bitboard_move = bitboard_moves[get_bitboard_move_index(piece_index, direction, piece_top_left)];
 
-				path_t new_path = get_path_copy(path);
+					bitboard_move.collision = {};
+					bitboard_move.toggled = {};
 
-				new_path.push_back({piece_index, direction});
+					for (const auto &offset : emptied_offsets.pieces[piece_index].directions[direction].offsets)
+					{
+						bitboard_move.toggled.set(x + offset.x + (y + offset.y) * width);
+					}
 
-				path_queue.push(new_path);
+					for (const auto &offset : collision_offsets.pieces[piece_index].directions[direction].offsets)
+					{
+						const int collision_x = x + offset.x;
+						const int collision_y = y + offset.y;
 
-				state_count++;
-			}
+						// The piece always collides with itself, which takes care of the out of bounds check in advance.
+						if (is_out_of_bounds(collision_x, collision_y))
+						{
+							bitboard_move.collision = piece_bitboard;
+							break;
+						}
 
-			move(piece_top_left, piece_index, get_inverted_direction(direction), cells);
+						bitboard_move.collision.set(collision_x + collision_y * width);
+						bitboard_move.toggled.set(collision_x + collision_y * width);
+					}
+				}
+			}
 		}
 	}
 }
 
 
-bool SlidingPuzzleSolver::cant_move(const Pos &piece_top_left, const cell_id piece_index, const piece_direction direction, cells_t &cells)
+Bitboard SlidingPuzzleSolver::get_piece_bitboard(const cell_id piece_index, const Pos &piece_top_left)
 {
-	const auto &collision_piece = collision_offsets.pieces[piece_index];
+	Bitboard piece_bitboard = {};
 
-	const auto &collision_piece_direction = collision_piece.directions[direction];
-
-	for (const auto offset : collision_piece_direction.offsets)
+	for (const auto &rect : starting_pieces_info[piece_index].rects)
 	{
-		const auto x = piece_top_left.x + offset.x;
-		const auto y = piece_top_left.y + offset.y;
-
-		if (is_out_of_bounds(x, y))
+		for (int y_offset = 0; y_offset < rect.size.height; ++y_offset)
 		{
-			return true;
-		}
+			for (int x_offset = 0; x_offset < rect.size.width; ++x_offset)
+			{
+				const int x = piece_top_left.x + rect.offset.x + x_offset;
+				const int y = piece_top_left.y + rect.offset.y + y_offset;
 
-		if (cells[y][x] != empty_cell_id)
-		{
-			return true;
+				piece_bitboard.set(x + y * width);
+			}
 		}
 	}
 
-	return false;
+	return piece_bitboard;
 }
 
 
-void SlidingPuzzleSolver::move(Pos &piece_top_left, const cell_id piece_index, const piece_direction direction, cells_t &cells)
+bool SlidingPuzzleSolver::is_piece_in_bounds(const cell_id piece_index, const Pos &piece_top_left)
 {
-	const auto &piece_emptied_offsets = emptied_offsets.pieces[piece_index].directions[direction].offsets;
-
-	apply_offsets_to_cells(cells, piece_top_left, piece_emptied_offsets, empty_cell_id);
-
-	const auto &piece_collision_offsets = collision_offsets.pieces[piece_index].directions[direction].offsets;
+	for (const auto &rect : starting_pieces_info[piece_index].rects)
+	{
+		const int rect_left = piece_top_left.x + rect.offset.x;
+		const int rect_top = piece_top_left.y + rect.offset.y;
 
-	apply_offsets_to_cells(cells, piece_top_left, piece_collision_offsets, piece_index);
+		if (is_out_of_bounds(rect_left, rect_top) || is_out_of_bounds(rect_left + rect.size.width - 1, rect_top + rect.size.height - 1))
+		{
+			return false;
+		}
+	}
 
-	move_piece_top_left(piece_top_left, direction);
+	return true;
 }
 
 
-void SlidingPuzzleSolver::apply_offsets_to_cells(cells_t &cells, Pos &piece_top_left, const std::vector<Offset> &offsets, const cell_id index)
+std::size_t SlidingPuzzleSolver::get_bitboard_move_index(const cell_id piece_index, const piece_direction direction, const Pos &piece_top_left)
 {
-	for (const auto &offset : offsets)
-	{
-		const int x = piece_top_left.x + offset.x;
-		const int y = piece_top_left.y + offset.y;
+	const std::size_t cell_index = piece_top_left.x + piece_top_left.y * width;
 
-		cells[y][x] = index;
-	}
+	return (piece_index * direction_count + direction) * (width * height) + cell_index;
 }
 
 
-void SlidingPuzzleSolver::move_piece_top_left(Pos &piece_top_left, const piece_direction direction)
+void SlidingPuzzleSolver::initialize_variable_fields(const json &puzzle_json)
 {
-	switch (direction)
-	{
-	case 0:
-		piece_top_left.y--;
-		break;
-	case 1:
-		piece_top_left.y++;
-		break;
-	case 2:
-		piece_top_left.x--;
-		break;
-	case 3:
-		piece_top_left.x++;
-		break;
-	}
-}
-
+	add_wall_cells(puzzle_json["walls"]);
 
-pieces_t SlidingPuzzleSolver::get_pieces_copy(const pieces_t &pieces)
-{
-	const pieces_t pieces_copy = pieces;
+	wall_cells = starting_cells;
 
-	return pieces_copy;
+	add_piece_cells(starting_cells, get_starting_pieces());
 }
 
 
-cells_t SlidingPuzzleSolver::get_cells_copy(const cells_t &cells)
+void SlidingPuzzleSolver::add_wall_cells(const json &walls_json)
 {
-	const cells_t cells_copy = cells;
-
-	return cells_copy;
-}
+	for (const auto &wall_json : walls_json)
+	{
+		Wall wall;
 
+		const json &wall_pos_json = wall_json["pos"];
+		wall.pos.x = wall_pos_json["x"];
+		wall.pos.y = wall_pos_json["y"];
 
-path_t SlidingPuzzleSolver::get_path_copy(const path_t &path)
-{
-	const path_t path_copy = path;
+		const json &wall_size_json = wall_json["size"];
+		wall.size.width = wall_size_json["width"];
+		wall.size.height = wall_size_json["height"];
 
-	return path_copy;
+		for (int y_offset = 0; y_offset < wall.size.height; ++y_offset)
+		{
+			for (int x_offset = 0; x_offset < wall.size.width; ++x_offset)
+			{
+				starting_cells[wall.pos.y + y_offset][wall.pos.x + x_offset] = wall_cell_id;
+			}
+		}
+	}
+}
+
+
+void SlidingPuzzleSolver::add_piece_cells(cells_t &cells, const pieces_t &pieces)
+{
+	for (cell_id starting_piece_info_index = 0; starting_piece_info_index != pieces_count; ++starting_piece_info_index)
+	{
+		const StartingPieceInfo &starting_piece_info = starting_pieces_info[starting_piece_info_index];
+		const Pos &top_left = pieces[starting_piece_info_index].top_left;
+
+		const std::vector<Rect> &rects = starting_piece_info.rects;
+		for (const auto &rect : rects)
+		{
+			const Offset &rect_offset = rect.offset;
+
+			const int rect_top_left_x = top_left.x + rect_offset.x;
+			const int rect_top_left_y = top_left.y + rect_offset.y;
+
+			const Size &rect_size = rect.size;
+
+			for (int y_offset = 0; y_offset < rect_size.height; ++y_offset)
+			{
+				for (int x_offset = 0; x_offset < rect_size.width; ++x_offset)
+				{
+					cells[rect_top_left_y + y_offset][rect_top_left_x + x_offset] = starting_piece_info_index;
+				}
+			}
+		}
+	}
+}
+
+
+void SlidingPuzzleSolver::set_board_from_pieces(cells_t &cells, const pieces_t &pieces)
+{
+	cells.resize(height);
+
+	// Assigning row by row reuses the rows' memory, unlike assigning wall_cells to cells would.
+	for (int y = 0; y < height; ++y)
+	{
+		cells[y].assign(wall_cells[y].cbegin(), wall_cells[y].cend());
+	}
+
+	add_piece_cells(cells, pieces);
+}
+
+
+void SlidingPuzzleSolver::set_board_from_pieces(Bitboard &bitboard, const pieces_t &pieces)
+{
+	bitboard = wall_bitboard;
+
+	for (cell_id piece_index = 0; piece_index != pieces_count; ++piece_index)
+	{
+		bitboard.toggle(get_piece_bitboard(piece_index, pieces[piece_index].top_left));
+	}
+}
+
+
+pieces_t SlidingPuzzleSolver::get_starting_pieces(void)
+{
+	pieces_t starting_pieces;
+
+	for (const auto &starting_piece_info : starting_pieces_info)
+	{
+		Piece piece;
+
+		piece.top_left = starting_piece_info.top_left;
+
+		starting_pieces.push_back(piece);
+	}
+
+	return starting_pieces;
+}
+
+
+state_key_t SlidingPuzzleSolver::get_state_key(const pieces_t &pieces)
+{
+	state_key_t state_key{};
+
+	for (cell_id piece_index = 0; piece_index != pieces_count; ++piece_index)
+	{
+		const Pos &piece_top_left = pieces[piece_index].top_left;
+
+		set_piece_cell_index(state_key, piece_index, piece_top_left.x + piece_top_left.y * width);
+	}
+
+	return state_key;
+}
+
+
+void SlidingPuzzleSolver::set_pieces_from_state_key(pieces_t &pieces, const state_key_t &state_key)
+{
+	for (cell_id piece_index = 0; piece_index != pieces_count; ++piece_index)
+	{
+		const int cell_index = get_piece_cell_index(state_key, piece_index);
+
+		Pos &piece_top_left = pieces[piece_index].top_left;
+		piece_top_left.x = cell_index % width;
+		piece_top_left.y = cell_index / width;
+	}
+}
+
+
+uint64_t SlidingPuzzleSolver::get_piece_cell_index(const state_key_t &state_key, const cell_id piece_index)
+{
+	const uint64_t piece_mask = (uint64_t(1) << bits_per_piece) - 1;
+
+	const int word_index = piece_index / pieces_per_state_key_word;
+	const int shift = (piece_index % pieces_per_state_key_word) * bits_per_piece;
+
+	return (state_key.words[word_index] >> shift) & piece_mask;
+}
+
+
+void SlidingPuzzleSolver::set_piece_cell_index(state_key_t &state_key, const cell_id piece_index, const uint64_t cell_index)
+{
+	const uint64_t piece_mask = (uint64_t(1) << bits_per_piece) - 1;
+
+	const int word_index = piece_index / pieces_per_state_key_word;
+	const int shift = (piece_index % pieces_per_state_key_word) * bits_per_piece;
+
+	uint64_t &word = state_key.words[word_index];
+	word = (word & ~(piece_mask << shift)) | (cell_index << shift);
+}
+
+
+state_key_t SlidingPuzzleSolver::get_canonical_state_key(const state_key_t &state_key)
+{
+	state_key_t canonical_state_key = state_key;
+
+	// Every piece takes up at least one bit, so no class can be bigger than this.
+	std::array<uint64_t, state_key_words * state_key_word_bits> cell_indices;
+
+	// Interchangeable pieces are sorted by their top-left cell index, so all their permutations share one key.
+	for (const auto &identical_pieces : identical_piece_classes)
+	{
+		const std::size_t identical_pieces_count = identical_pieces.size();
+
+		for (std::size_t class_index = 0; class_index < identical_pieces_count; ++class_index)
+		{
+			cell_indices[class_index] = get_piece_cell_index(state_key, identical_pieces[class_index]);
+		}
+
+		std::sort(cell_indices.begin(), cell_indices.begin() + identical_pieces_count);
+
+		for (std::size_t class_index = 0; class_index < identical_pieces_count; ++class_index)
+		{
+			set_piece_cell_index(canonical_state_key, identical_pieces[class_index], cell_indices[class_index]);
+		}
+	}
+
+	return canonical_state_key;
+}
+
+
+state_key_t SlidingPuzzleSolver::get_mirrored_state_key(const state_key_t &state_key)
+{
+	state_key_t mirrored_state_key = state_key;
+
+	for (cell_id piece_index = 0; piece_index != pieces_count; ++piece_index)
+	{
+		const uint64_t cell_index = get_piece_cell_index(state_key, piece_index);
+
+		set_piece_cell_index(mirrored_state_key, piece_index, mirrored_cell_indices[piece_index][cell_index]);
+	}
+
+	return mirrored_state_key;
+}
+
+
+state_key_t SlidingPuzzleSolver::get_visited_state_key(const state_key_t &state_key)
+{
+	const state_key_t canonical_state_key = get_canonical_state_key(state_key);
+
+	if (!is_mirror_symmetric)
+	{
+		return canonical_state_key;
+	}
+
+	// A state and its mirror image both map to whichever of their two keys is smaller.
+	const state_key_t canonical_mirrored_state_key = get_canonical_state_key(get_mirrored_state_key(state_key));
+
+	return std::min(canonical_state_key, canonical_mirrored_state_key);
+}
+
+
+void SlidingPuzzleSolver::set_mirrored_pieces(pieces_t &mirrored_pieces, const pieces_t &pieces)
+{
+	for (cell_id piece_index = 0; piece_index != pieces_count; ++piece_index)
+	{
+		const Pos &top_left = pieces[piece_index].top_left;
+		const int mirrored_cell_index = mirrored_cell_indices[piece_index][top_left.x + top_left.y * width];
+
+		Pos &mirrored_top_left = mirrored_pieces[piece_index].top_left;
+		mirrored_top_left.x = mirrored_cell_index % width;
+		mirrored_top_left.y = mirrored_cell_index / width;
+	}
+}
+
+
+bool SlidingPuzzleSolver::add_state(const state_key_t &state_key)
+{
+#ifdef UNORDERED_STATE_SET
+	const std::pair<states_t::iterator, bool> insert_info = states.insert(state_key);
+
+	const bool success = insert_info.second;
+#else
+	const bool success = states.insert(state_key);
+#endif
+
+	return success;
+}
+
+
+std::size_t SlidingPuzzleSolver::get_states_capacity(void)
+{
+#ifdef UNORDERED_STATE_SET
+	return states.bucket_count();
+#else
+	return states.capacity();
+#endif
+}
+
+
+void SlidingPuzzleSolver::solve(void)
+{
+	board_printer.print_board(get_starting_pieces());
+
+	// Queries are answered straight from the file, without searching or printing progress.
+	if (!options.distance_database_path.empty())
+	{
+		distance_database.load(options.distance_database_path);
+		distance_database.print_query();
+		return;
+	}
+
+	metrics_writer.open();
+
+	// TODO: Can this line be shortened?
+	std::thread timed_print_thread(&TimedPrinter::timed_print, &timed_printer);
+
+	try
+	{
+		run_search();
+	}
+	catch (...)
+	{
+		// The printing thread has to be joined before the exception can leave, or its destructor terminates the program.
+		finished = true;
+		timed_print_thread.join();
+		throw;
+	}
+
+	// Also lets timed_print() stop when every reachable state has been visited without finding the goal.
+	finished = true;
+
+	// Taken before waiting for the printing thread to wake up, which can take up to a second.
+	const std::chrono::steady_clock::time_point end_time = std::chrono::steady_clock::now();
+
+	timed_print_thread.join();
+
+	metrics_writer.write_summary(end_time);
+
+	if (options.enumerate)
+	{
+		enumeration.write_stats();
+	}
+}
+
+
+void SlidingPuzzleSolver::run_search(void)
+{
+	const bool runs_single_threaded_bfs = !options.enumerate && options.distance_database_out_path.empty() && options.search == "bfs" && options.thread_count == 1;
+
+	if ((!options.checkpoint_path.empty() || options.resume) && !runs_single_threaded_bfs)
+	{
+		throw std::invalid_argument("Only the single-threaded BFS can write checkpoints and resume from them");
+	}
+
+	if (options.resume && options.checkpoint_path.empty())
+	{
+		throw std::invalid_argument("--resume needs the --checkpoint to resume from");
+	}
+
+	if (options.enumerate)
+	{
+		enumeration.solve();
+	}
+	else if (!options.distance_database_out_path.empty())
+	{
+		distance_database.generate(options.distance_database_out_path);
+	}
+	else if (options.search == "bidirectional")
+	{
+		bidirectional_bfs.solve();
+	}
+	else if (options.search == "astar")
+	{
+		a_star.solve();
+	}
+	else if (options.search == "idastar")
+	{
+		ida_star.solve();
+	}
+	else if (options.search == "ranked")
+	{
+		ranked_bfs.solve();
+	}
+	else if (options.search == "external")
+	{
+		external_bfs.solve();
+	}
+	else if (options.search == "frontier")
+	{
+		frontier_search.solve();
+	}
+	else if (options.thread_count > 1)
+	{
+		parallel_bfs.solve();
+	}
+	else
+	{
+		solve_bfs();
+	}
+}
+
+
+void SlidingPuzzleSolver::solve_bfs(void)
+{
+	const auto starting_pieces = get_starting_pieces();
+
+	pieces_queue_t pieces_queue;
+
+	// States are discovered in BFS order, so all states of the next path length come after this index.
+	uint32_t next_path_length_state_index = 1;
+
+	const bool is_checkpointing = !options.checkpoint_path.empty();
+
+	if (!options.resume || !bfs_checkpoint.load(states, state_records, pieces_queue, next_path_length_state_index))
+	{
+		const state_key_t starting_state_key = get_state_key(starting_pieces);
+
+		add_state(get_visited_state_key(starting_state_key));
+
+		// The starting state is its own parent, which is where get_path() stops walking back.
+		state_records.push_back({0, 0, 0});
+		pieces_queue.push({starting_state_key, 0});
+	}
+
+	pieces_t pieces = starting_pieces;
+
+	// Every dequeued state's board is rebuilt in here, instead of every queued state owning a copy.
+	board_t board;
+
+	ProgressCounters::Slot &progress = progress_counters.get_slot();
+
+	while (!pieces_queue.empty())
+	{
+		progress_counters.frontier_size = pieces_queue.size();
+
+		const auto [state_key, state_index] = pieces_queue.front();
+		pieces_queue.pop();
+
+		if (state_index >= next_path_length_state_index)
+		{
+			progress_counters.depth++;
+			next_path_length_state_index = state_records.size();
+		}
+
+		set_pieces_from_state_key(pieces, state_key);
+		set_board_from_pieces(board, pieces);
+
+		// print_board(pieces);
+		// std::cout << std::endl;
+
+		update_finished(pieces, state_index);
+		if (finished)
+		{
+			break;
+		}
+
+		queue_valid_moves(pieces_queue, pieces, board, state_index);
+
+		progress.tested_move_count += pieces_count * direction_count;
+		progress.expanded_state_count++;
+
+		progress_counters.visited_state_set_size = states.size();
+		progress_counters.visited_state_set_capacity = get_states_capacity();
+
+		if (is_checkpointing)
+		{
+			bfs_checkpoint.update(states, state_records, pieces_queue, next_path_length_state_index);
+		}
+	}
+
+	bfs_checkpoint.finish();
+}
+
+
+void SlidingPuzzleSolver::update_finished(const pieces_t &pieces, const uint32_t state_index)
+{
+	if (!is_goal(pieces))
+	{
+		return;
+	}
+
+	// The path has to be filled in before finished is set, as timed_print() prints it as soon as it sees finished.
+	path = get_path(state_records, state_index);
+
+	finished = true;
+}
+
+
+bool SlidingPuzzleSolver::is_goal(const pieces_t &pieces)
+{
+	for (const auto &ending_piece : ending_pieces)
+	{
+		const cell_id ending_piece_index = ending_piece.piece_index;
+		const Pos &ending_piece_top_left = ending_piece.top_left;
+
+		const Piece &piece = pieces[ending_piece_index];
+		const Pos &piece_top_left = piece.top_left;
+
+		// TODO: Use a friend declared operator != to do pos comparison instead?
+		if (ending_piece_top_left.x != piece_top_left.x || ending_piece_top_left.y != piece_top_left.y)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+path_t SlidingPuzzleSolver::get_path(const state_records_t &state_records, uint32_t state_index)
+{
+	path_t reversed_path;
+
+	while (state_index != 0)
+	{
+		const StateRecord &state_record = state_records[state_index];
+
+		reversed_path.push_back({state_record.piece_index, state_record.direction});
+
+		state_index = state_record.parent_index;
+	}
+
+	return path_t(reversed_path.rbegin(), reversed_path.rend());
+}
+
+
+std::vector<state_key_t> SlidingPuzzleSolver::get_goal_state_keys(void)
+{
+	std::vector<state_key_t> goal_state_keys;
+	states_t goal_states;
+
+	pieces_t pieces = get_starting_pieces();
+	cells_t cells = wall_cells;
+
+	for (const auto &ending_piece : ending_pieces)
+	{
+		const cell_id ending_piece_index = ending_piece.piece_index;
+
+		// Ending pieces that overlap a wall or each other can't ever be satisfied.
+		if (!is_piece_in_bounds(ending_piece_index, ending_piece.top_left) || !can_place_piece(cells, ending_piece_index, ending_piece.top_left))
+		{
+			return goal_state_keys;
+		}
+
+		pieces[ending_piece_index].top_left = ending_piece.top_left;
+		set_piece_cells(cells, ending_piece_index, ending_piece.top_left, ending_piece_index);
+	}
+
+	add_goal_state_keys(goal_state_keys, goal_states, pieces, cells, 0);
+
+	return goal_state_keys;
+}
+
+
+void SlidingPuzzleSolver::add_goal_state_keys(std::vector<state_key_t> &goal_state_keys, states_t &goal_states, pieces_t &pieces, cells_t &cells, const cell_id piece_index)
+{
+	if (piece_index == pieces_count)
+	{
+		const state_key_t state_key = get_state_key(pieces);
+
+#ifdef UNORDERED_STATE_SET
+		const bool is_new = goal_states.insert(get_visited_state_key(state_key)).second;
+#else
+		const bool is_new = goal_states.insert(get_visited_state_key(state_key));
+#endif
+
+		if (is_new)
+		{
+			if (goal_state_keys.size() == max_goal_state_count)
+			{
+				throw std::runtime_error("The goal leaves more than " + std::to_string(max_goal_state_count) + " placements of the other pieces, so use \"--search bfs\" instead");
+			}
+
+			goal_state_keys.push_back(state_key);
+		}
+
+		return;
+	}
+
+	if (is_ending_piece(piece_index))
+	{
+		add_goal_state_keys(goal_state_keys, goal_states, pieces, cells, piece_index + 1);
+		return;
+	}
+
+	// Identical pieces are placed in increasing cell index order, as their other orders all share a visited state key.
+	const cell_id previous_identical_piece_index = previous_identical_piece_indices[piece_index];
+	const int first_cell_index = previous_identical_piece_index == -1 ? 0 : pieces[previous_identical_piece_index].top_left.x + pieces[previous_identical_piece_index].top_left.y * width + 1;
+
+	for (int cell_index = first_cell_index; cell_index < width * height; ++cell_index)
+	{
+		const Pos piece_top_left = {cell_index % width, cell_index / width};
+
+		if (!is_piece_in_bounds(piece_index, piece_top_left) || !can_place_piece(cells, piece_index, piece_top_left))
+		{
+			continue;
+		}
+
+		pieces[piece_index].top_left = piece_top_left;
+
+		set_piece_cells(cells, piece_index, piece_top_left, piece_index);
+		add_goal_state_keys(goal_state_keys, goal_states, pieces, cells, piece_index + 1);
+		set_piece_cells(cells, piece_index, piece_top_left, empty_cell_id);
+	}
+}
+
+
+// Files that are only valid for one puzzle store this, which changes along with the walls, the piece shapes and the ending pieces, but not the starting pieces.
+uint64_t SlidingPuzzleSolver::get_puzzle_fingerprint(void)
+{
+	// FNV-1a
+	uint64_t fingerprint = 0xcbf29ce484222325ULL;
+
+	const auto add = [&fingerprint](const int value)
+	{
+		fingerprint = (fingerprint ^ static_cast<uint32_t>(value)) * 0x100000001b3ULL;
+	};
+
+	add(width);
+	add(height);
+
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			add(wall_cells[y][x] == wall_cell_id);
+		}
+	}
+
+	add(pieces_count);
+
+	for (const auto &starting_piece_info : starting_pieces_info)
+	{
+		add(starting_piece_info.rects.size());
+
+		for (const auto &rect : starting_piece_info.rects)
+		{
+			add(rect.offset.x);
+			add(rect.offset.y);
+			add(rect.size.width);
+			add(rect.size.height);
+		}
+	}
+
+	for (const auto &ending_piece : ending_pieces)
+	{
+		add(ending_piece.piece_index);
+		add(ending_piece.top_left.x);
+		add(ending_piece.top_left.y);
+	}
+
+	return fingerprint;
+}
+
+
+std::vector<int> SlidingPuzzleSolver::get_wall_distances(const EndingPiece &ending_piece)
+{
+	const cell_id piece_index = ending_piece.piece_index;
+
+	// Indexed by cell index, this is how many moves the piece needs to reach its ending position from there with only the walls around.
+	std::vector<int> wall_distances(width * height, -1);
+
+	std::queue<Pos> top_lefts;
+
+	wall_distances[ending_piece.top_left.x + ending_piece.top_left.y * width] = 0;
+	top_lefts.push(ending_piece.top_left);
+
+	while (!top_lefts.empty())
+	{
+		const Pos top_left = top_lefts.front();
+		top_lefts.pop();
+
+		const int distance = wall_distances[top_left.x + top_left.y * width];
+
+		for (piece_direction direction = 0; direction < direction_count; ++direction)
+		{
+			Pos next_top_left = top_left;
+			move_piece_top_left(next_top_left, direction);
+
+			if (!is_piece_in_bounds(piece_index, next_top_left) || !can_place_piece(wall_cells, piece_index, next_top_left))
+			{
+				continue;
+			}
+
+			int &next_distance = wall_distances[next_top_left.x + next_top_left.y * width];
+
+			if (next_distance == -1)
+			{
+				next_distance = distance + 1;
+				top_lefts.push(next_top_left);
+			}
+		}
+	}
+
+	return wall_distances;
+}
+
+
+std::vector<int> SlidingPuzzleSolver::get_wall_free_cell_indices(const cell_id piece_index)
+{
+	std::vector<int> wall_free_cell_indices;
+
+	for (int cell_index = 0; cell_index < width * height; ++cell_index)
+	{
+		const Pos piece_top_left = {cell_index % width, cell_index / width};
+
+		if (is_piece_in_bounds(piece_index, piece_top_left) && can_place_piece(wall_cells, piece_index, piece_top_left))
+		{
+			wall_free_cell_indices.push_back(cell_index);
+		}
+	}
+
+	return wall_free_cell_indices;
+}
+
+
+// Leaves out every piece that isn't in the pattern, as if it weren't on the board.
+void SlidingPuzzleSolver::set_board_from_pattern_pieces(cells_t &cells, const pieces_t &pieces, const std::vector<cell_id> &pattern_piece_indices)
+{
+	cells = wall_cells;
+
+	for (const auto piece_index : pattern_piece_indices)
+	{
+		set_piece_cells(cells, piece_index, pieces[piece_index].top_left, piece_index);
+	}
+}
+
+
+void SlidingPuzzleSolver::set_board_from_pattern_pieces(Bitboard &bitboard, const pieces_t &pieces, const std::vector<cell_id> &pattern_piece_indices)
+{
+	bitboard = wall_bitboard;
+
+	for (const auto piece_index : pattern_piece_indices)
+	{
+		bitboard.toggle(get_piece_bitboard(piece_index, pieces[piece_index].top_left));
+	}
+}
+
+
+bool SlidingPuzzleSolver::can_place_piece(const cells_t &cells, const cell_id piece_index, const Pos &piece_top_left)
+{
+	for (const auto &rect : starting_pieces_info[piece_index].rects)
+	{
+		for (int y_offset = 0; y_offset < rect.size.height; ++y_offset)
+		{
+			for (int x_offset = 0; x_offset < rect.size.width; ++x_offset)
+			{
+				if (cells[piece_top_left.y + rect.offset.y + y_offset][piece_top_left.x + rect.offset.x + x_offset] != empty_cell_id)
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+
+void SlidingPuzzleSolver::set_piece_cells(cells_t &cells, const cell_id piece_index, const Pos &piece_top_left, const cell_id value)
+{
+	for (const auto &rect : starting_pieces_info[piece_index].rects)
+	{
+		for (int y_offset = 0; y_offset < rect.size.height; ++y_offset)
+		{
+			for (int x_offset = 0; x_offset < rect.size.width; ++x_offset)
+			{
+				cells[piece_top_left.y + rect.offset.y + y_offset][piece_top_left.x + rect.offset.x + x_offset] = value;
+			}
+		}
+	}
+}
+
+
+path_t SlidingPuzzleSolver::get_path_through_visited_state_keys(const std::vector<state_key_t> &visited_state_keys)
+{
+	path_t path;
+
+	pieces_t pieces = get_starting_pieces();
+
+	board_t board;
+	set_board_from_pieces(board, pieces);
+
+	// Only the visited state keys are known, which can be mirrored or have identical pieces swapped,
+	// so every step looks for the real move that leads to a state with the next visited state key.
+	for (std::size_t step = 1; step < visited_state_keys.size(); ++step)
+	{
+		bool found_move = false;
+
+		for (cell_id piece_index = 0; piece_index != pieces_count && !found_move; ++piece_index)
+		{
+			Pos &piece_top_left = pieces[piece_index].top_left;
+
+			for (piece_direction direction = 0; direction < direction_count; ++direction)
+			{
+				if (cant_move(piece_top_left, piece_index, direction, board))
+				{
+					continue;
+				}
+
+				move(piece_top_left, piece_index, direction, board);
+
+				if (get_visited_state_key(get_state_key(pieces)) == visited_state_keys[step])
+				{
+					path.push_back({piece_index, direction});
+					found_move = true;
+					break;
+				}
+
+				move(piece_top_left, piece_index, get_inverted_direction(direction), board);
+			}
+		}
+
+		if (!found_move)
+		{
+			throw std::logic_error("No move leads from one state of the path to the next");
+		}
+	}
+
+	return path;
+}
+
+
+void SlidingPuzzleSolver::queue_valid_moves(pieces_queue_t &pieces_queue, pieces_t &pieces, board_t &board, const uint32_t parent_index)
+{
+	ProgressCounters::Slot &progress = progress_counters.get_slot();
+
+	for (cell_id piece_index = 0; piece_index != pieces_count; ++piece_index)
+	{
+		Piece &piece = pieces[piece_index];
+		Pos &piece_top_left = piece.top_left;
+
+		for (piece_direction direction = 0; direction < direction_count; ++direction)
+		{
+			if (cant_move(piece_top_left, piece_index, direction, board))
+			{
+				continue;
+			}
+
+			move(piece_top_left, piece_index, direction, board);
+
+			progress.generated_state_count++;
+
+			const state_key_t state_key = get_state_key(pieces);
+
+			if (add_state(get_visited_state_key(state_key)))
+			{
+				const uint32_t state_index = state_records.size();
+
+				state_records.push_back({parent_index, static_cast<uint8_t>(piece_index), static_cast<uint8_t>(direction)});
+
+				pieces_queue.push({state_key, state_index});
+
+				progress.unique_state_count++;
+			}
+
+			move(piece_top_left, piece_index, get_inverted_direction(direction), board);
+		}
+	}
+}
+
+
+bool SlidingPuzzleSolver::cant_move(const Pos &piece_top_left, const cell_id piece_index, const piece_direction direction, cells_t &cells)
+{
+	const auto &collision_piece = collision_offsets.pieces[piece_index];
+
+	const auto &collision_piece_direction = collision_piece.directions[direction];
+
+	for (const auto offset : collision_piece_direction.offsets)
+	{
+		const auto x = piece_top_left.x + offset.x;
+		const auto y = piece_top_left.y + offset.y;
+
+		if (is_out_of_bounds(x, y))
+		{
+			return true;
+		}
+
+		if (cells[y][x] != empty_cell_id)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+bool SlidingPuzzleSolver::cant_move(const Pos &piece_top_left, const cell_id piece_index, const piece_direction direction, Bitboard &bitboard)
+{
+	const BitboardMove &bitboard_move = bitboard_moves[get_bitboard_move_index(piece_index, direction, piece_top_left)];
+
+	return bitboard.intersects(bitboard_move.collision);
+}
+
+
+void SlidingPuzzleSolver::move(Pos &piece_top_left, const cell_id piece_index, const piece_direction direction, cells_t &cells)
+{
+	const auto &piece_emptied_offsets = emptied_offsets.pieces[piece_index].directions[direction].offsets;
+
+	apply_offsets_to_cells(cells, piece_top_left, piece_emptied_offsets, empty_cell_id);
+
+	const auto &piece_collision_offsets = collision_offsets.pieces[piece_index].directions[direction].offsets;
+
+	apply_offsets_to_cells(cells, piece_top_left, piece_collision_offsets, piece_index);
+
+	move_piece_top_left(piece_top_left, direction);
+}
+
+
+void SlidingPuzzleSolver::move(Pos &piece_top_left, const cell_id piece_index, const piece_direction direction, Bitboard &bitboard)
+{
+	const BitboardMove &bitboard_move = bitboard_moves[get_bitboard_move_index(piece_index, direction, piece_top_left)];
+
+	bitboard.toggle(bitboard_move.toggled);
+
+	move_piece_top_left(piece_top_left, direction);
+}
+
+
+void SlidingPuzzleSolver::apply_offsets_to_cells(cells_t &cells, Pos &piece_top_left, const std::vector<Offset> &offsets, const cell_id index)
+{
+	for (const auto &offset : offsets)
+	{
+		const int x = piece_top_left.x + offset.x;
+		const int y = piece_top_left.y + offset.y;
+
+		cells[y][x] = index;
+	}
+}
+
+
+void SlidingPuzzleSolver::move_piece_top_left(Pos &piece_top_left, const piece_direction direction)
+{
+	switch (direction)
+	{
+	case 0:
+		piece_top_left.y--;
+		break;
+	case 1:
+		piece_top_left.y++;
+		break;
+	case 2:
+		piece_top_left.x--;
+		break;
+	case 3:
+		piece_top_left.x++;
+		break;
+	}
 }
+
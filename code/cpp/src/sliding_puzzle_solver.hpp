@@ -10,7 +10,10 @@
 // #include <chrono>
 
 #include <thread>
+#include <atomic>
 #include <filesystem>
+#include <stdexcept>
+#include <algorithm>
 
 
 #include "typedefs.hpp"
@@ -21,16 +24,42 @@ using json = nlohmann::json;
 
 #include "pieces.hpp"
 #include "kilo_formatter.h"
+#include "options.hpp"
+
+
+#include "metrics/progress_counters.hpp"
+#include "metrics/metrics_writer.hpp"
+
+
+#include "state/flat_state_set.hpp"
+
+// Build with "make STATE_SET=unordered" to compare against the standard library's hash set.
+#ifdef UNORDERED_STATE_SET
+typedef std::unordered_set<state_key_t, StateKey::HashFunction> states_t;
+#else
+typedef FlatStateSet states_t;
+#endif
 
 
 #include "printer/board_printer.hpp"
 #include "printer/timed_printer.hpp"
 
+#include "search/parallel_bfs.hpp"
+#include "search/bidirectional_bfs.hpp"
+#include "search/a_star.hpp"
+#include "search/ida_star.hpp"
+#include "search/enumeration.hpp"
+#include "search/distance_database.hpp"
+#include "search/ranked_bfs.hpp"
+#include "search/external_bfs.hpp"
+#include "search/frontier_search.hpp"
+#include "search/bfs_checkpoint.hpp"
+
 
 class SlidingPuzzleSolver
 {
 public:
-	SlidingPuzzleSolver(std::filesystem::path &exe_path, const std::string &puzzle_name);
+	SlidingPuzzleSolver(std::filesystem::path &exe_path, const Options &options);
 	void solve(void);
 
 
@@ -39,14 +68,16 @@ public:
 	static char const wall_character = '#';
 
 	// TODO: Support more than 26 piece labels in some way.
-	static std::string constexpr piece_labels = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+	static std::string_view constexpr piece_labels = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
 
-	static std::vector<char> constexpr direction_characters = {'^', 'v', '<', '>'};
+	static std::array<char, 4> constexpr direction_characters = {'^', 'v', '<', '>'};
 
 
 	// Constants ////////
 	const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
 
+	const Options options;
+
 
 	// Constants after constructor ////////
 	std::vector<Wall> walls;
@@ -58,19 +89,79 @@ public:
 
 	int pieces_count;
 
+	std::vector<EndingPiece> ending_pieces;
+
+	/*
+	Pieces with identical rects that don't have to end up anywhere in particular are interchangeable,
+	so swapping two of them doesn't result in a new state.
+	Every class here holds the indices of at least two such pieces.
+	*/
+	std::vector<std::vector<cell_id>> identical_piece_classes;
+
+	/*
+	Whether the walls, the piece shapes and the ending pieces look the same when mirrored horizontally.
+	A state and its mirror image are then equally far from the goal, so only one of the two has to be visited.
+	*/
+	bool is_mirror_symmetric;
+
+	// Zero when the puzzle JSON doesn't give an "expected_state_count" hint.
+	std::size_t expected_state_count = 0;
+
 
 	// Variables ////////
-	bool finished = false;
+	// Set by the searching thread and read by the printing thread.
+	std::atomic<bool> finished = false;
 
-	int state_count = 0;
-	int prev_state_count = 0;
+	// Sized by the thread count, and read by the printing thread while the search writes to it.
+	ProgressCounters progress_counters;
 
+	// Written to by the printing thread, which also reports the progress to --metrics-out.
+	MetricsWriter metrics_writer;
 
-private:
+	// Only filled in once the goal has been found.
+	path_t path;
+
+
+	// Methods shared with the search strategies in search/ ////////
 	static int const direction_count = 4;
 
+	pieces_t get_starting_pieces(void);
+	void set_board_from_pieces(cells_t &cells, const pieces_t &pieces);
+	void set_board_from_pieces(Bitboard &bitboard, const pieces_t &pieces);
+
+	state_key_t get_state_key(const pieces_t &pieces);
+	void set_pieces_from_state_key(pieces_t &pieces, const state_key_t &state_key);
+	state_key_t get_visited_state_key(const state_key_t &state_key);
+	void set_mirrored_pieces(pieces_t &mirrored_pieces, const pieces_t &pieces);
+
+	bool is_goal(const pieces_t &pieces);
+	path_t get_path(const state_records_t &state_records, uint32_t state_index);
+
+	std::vector<state_key_t> get_goal_state_keys(void);
+	uint64_t get_puzzle_fingerprint(void);
+	std::vector<int> get_wall_distances(const EndingPiece &ending_piece);
+	std::vector<int> get_wall_free_cell_indices(const cell_id piece_index);
+	void set_board_from_pattern_pieces(cells_t &cells, const pieces_t &pieces, const std::vector<cell_id> &pattern_piece_indices);
+	void set_board_from_pattern_pieces(Bitboard &bitboard, const pieces_t &pieces, const std::vector<cell_id> &pattern_piece_indices);
+	path_t get_path_through_visited_state_keys(const std::vector<state_key_t> &visited_state_keys);
+
+	bool cant_move(const Pos &piece_top_left, const cell_id piece_index, const piece_direction direction, cells_t &cells);
+	bool cant_move(const Pos &piece_top_left, const cell_id piece_index, const piece_direction direction, Bitboard &bitboard);
+	void move(Pos &piece_top_left, const cell_id piece_index, const piece_direction direction, cells_t &cells);
+	void move(Pos &piece_top_left, const cell_id piece_index, const piece_direction direction, Bitboard &bitboard);
+	piece_direction get_inverted_direction(const piece_direction &direction);
+
+
+	// The move_bench tool times the private hot path methods directly.
+	friend struct MoveBench;
+
+
+private:
 	int const no_undo = -1;
 
+	// Puzzles whose goal leaves this many placements of the other pieces are better off with the plain BFS.
+	static std::size_t const max_goal_state_count = 1 << 22;
+
 	struct pieces_directions_cell_offsets
 	{
 		struct directions
@@ -92,8 +183,20 @@ private:
 
 
 	// Subclass singletons
-	const BoardPrinter board_printer;
-	const TimedPrinter timed_printer;
+	BoardPrinter board_printer;
+	TimedPrinter timed_printer;
+
+	ParallelBfs parallel_bfs;
+	BidirectionalBfs bidirectional_bfs;
+	AStar a_star;
+	IdaStar ida_star;
+	Enumeration enumeration;
+	DistanceDatabase distance_database;
+	RankedBfs ranked_bfs;
+	ExternalBfs external_bfs;
+	FrontierSearch frontier_search;
+
+	BfsCheckpoint bfs_checkpoint;
 
 
 	// Constants ////////
@@ -103,8 +206,6 @@ private:
 
 
 	// Constants after constructor ////////
-	std::vector<EndingPiece> ending_pieces;
-
 	/*
 	If this piece needs to move left:
 	" pppp"
@@ -133,9 +234,30 @@ private:
 
 	cells_t starting_cells;
 
+	// Only the walls, which the cells of every dequeued state are rebuilt on top of.
+	cells_t wall_cells;
+
+	Bitboard wall_bitboard;
+
+	// Indexed by get_bitboard_move_index(), so every piece in every direction from every top-left has its own masks.
+	std::vector<BitboardMove> bitboard_moves;
+
+	// Indexed by piece index, this is the piece before it in its identical piece class, or -1.
+	std::vector<cell_id> previous_identical_piece_indices;
+
+	// Indexed by piece index and then by cell index, this is the cell index of the piece's mirrored top-left.
+	std::vector<std::vector<uint64_t>> mirrored_cell_indices;
+
+	// The number of bits a piece's top-left cell index takes up in a state key.
+	int bits_per_piece;
+	int pieces_per_state_key_word;
+
 
 	// Variables ////////
-	std::unordered_set<pieces_t, Piece::HashFunction> states;
+	states_t states;
+
+	// Indexed by the order in which the states were discovered.
+	state_records_t state_records;
 
 
 	// Methods ////////
@@ -150,6 +272,11 @@ private:
 
 	void set_ending_pieces(const json &starting_pieces_json);
 
+	void set_identical_piece_classes(void);
+	bool is_ending_piece(const cell_id piece_index);
+
+	void reserve_states(const json &puzzle_json);
+
 	void set_walls(const json &walls_json);
 	void set_width_and_height(void);
 
@@ -158,34 +285,51 @@ private:
 	void add_offset_to_emptied_offsets(const int x, const int y, const cell_id piece_index, const piece_direction direction);
 
 	void set_collision_offsets(void);
-	piece_direction get_inverted_direction(const piece_direction &direction);
+
+	void set_mirror_symmetry(void);
+	bool are_walls_mirror_symmetric(void);
+	int get_mirrored_x_sum(const cell_id piece_index);
+	bool is_piece_mirror_symmetric(const cell_id piece_index);
+
+	void set_bitboard_moves(void);
+	bool is_piece_in_bounds(const cell_id piece_index, const Pos &piece_top_left);
+	Bitboard get_piece_bitboard(const cell_id piece_index, const Pos &piece_top_left);
+	std::size_t get_bitboard_move_index(const cell_id piece_index, const piece_direction direction, const Pos &piece_top_left);
+
+	void set_state_key_layout(void);
 
 	// Initialize variables
 	void initialize_variable_fields(const json &puzzle_json);
 
 	void set_starting_cells(void);
 	void add_wall_cells(const json &walls_json);
-	void add_piece_cells(void);
+	void add_piece_cells(cells_t &cells, const pieces_t &pieces);
 
 
 
-	pieces_t get_starting_pieces(void);
+	uint64_t get_piece_cell_index(const state_key_t &state_key, const cell_id piece_index);
+	void set_piece_cell_index(state_key_t &state_key, const cell_id piece_index, const uint64_t cell_index);
+	state_key_t get_canonical_state_key(const state_key_t &state_key);
+	state_key_t get_mirrored_state_key(const state_key_t &state_key);
+
 
+	void run_search(void);
+	void solve_bfs(void);
 
-	bool add_state(const pieces_t &pieces);
+	bool add_state(const state_key_t &state_key);
+	std::size_t get_states_capacity(void);
 
-	void update_finished(const pieces_t &pieces);
+	void update_finished(const pieces_t &pieces, const uint32_t state_index);
+
+	void add_goal_state_keys(std::vector<state_key_t> &goal_state_keys, states_t &goal_states, pieces_t &pieces, cells_t &cells, const cell_id piece_index);
+	bool can_place_piece(const cells_t &cells, const cell_id piece_index, const Pos &piece_top_left);
+	void set_piece_cells(cells_t &cells, const cell_id piece_index, const Pos &piece_top_left, const cell_id value);
 
 	// Move Pieces
-	void queue_valid_moves(pieces_queue_t &pieces_queue, pieces_t &pieces, cells_t &cells, path_queue_t &path_queue, const path_t &path);
-	bool cant_move(const Pos &piece_top_left, const cell_id piece_index, const piece_direction direction, cells_t &cells);
-	void move(Pos &piece_top_left, const cell_id piece_index, const piece_direction direction, cells_t &cells);
+	void queue_valid_moves(pieces_queue_t &pieces_queue, pieces_t &pieces, board_t &board, const uint32_t parent_index);
 	void apply_offsets_to_cells(cells_t &cells, Pos &piece_top_left, const std::vector<Offset> &offsets, const cell_id index);
 	void move_piece_top_left(Pos &piece_top_left, const piece_direction direction);
 
-	pieces_t get_pieces_copy(const pieces_t &pieces);
-	cells_t get_cells_copy(const cells_t &cells);
-	path_t get_path_copy(const path_t &path);
 
 	// bool a_rect_cant_be_moved(const std::vector<Rect> &rects, const piece_direction &direction, const cell_id piece_id, const Pos &piece_top_left);
 	// bool cant_move(const Rect &rect, const piece_direction &direction, const cell_id piece_id, const Pos &piece_top_left);
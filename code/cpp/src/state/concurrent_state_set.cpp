@@ -0,0 +1,169 @@
+#include "concurrent_state_set.hpp"
+
+
+ConcurrentStateSet::ConcurrentStateSet(void)
+	: slot_count(0), slot_index_mask(0), count(0)
+{
+	rehash(minimum_capacity);
+}
+
+
+void ConcurrentStateSet::reserve(const std::size_t expected_state_count)
+{
+	std::size_t new_capacity = slot_count;
+
+	// A maximum load factor of 1/2 keeps probe sequences short, even while threads are racing for slots.
+	while (new_capacity / 2 < expected_state_count)
+	{
+		new_capacity *= 2;
+	}
+
+	if (new_capacity != slot_count)
+	{
+		rehash(new_capacity);
+	}
+}
+
+
+bool ConcurrentStateSet::insert(const state_key_t &state_key)
+{
+	const uint64_t first_word = state_key.words[0];
+
+	if (first_word == empty_word || first_word == claimed_word)
+	{
+		const std::lock_guard<std::mutex> lock(reserved_first_word_keys_mutex);
+		return reserved_first_word_keys.insert(state_key);
+	}
+
+	for (std::size_t slot_index = get_start_slot_index(state_key); ; slot_index = (slot_index + 1) & slot_index_mask)
+	{
+		Slot &slot = slots[slot_index];
+
+		uint64_t slot_first_word = slot.first_word.load(std::memory_order_acquire);
+
+		if (slot_first_word == empty_word)
+		{
+			if constexpr (state_key_words == 1)
+			{
+				if (slot.first_word.compare_exchange_strong(slot_first_word, first_word, std::memory_order_acq_rel))
+				{
+					count.fetch_add(1, std::memory_order_relaxed);
+					return true;
+				}
+			}
+			else
+			{
+				if (slot.first_word.compare_exchange_strong(slot_first_word, claimed_word, std::memory_order_acquire))
+				{
+					for (std::size_t word_index = 1; word_index < state_key_words; ++word_index)
+					{
+						slot.other_words[word_index - 1] = state_key.words[word_index];
+					}
+
+					slot.first_word.store(first_word, std::memory_order_release);
+
+					count.fetch_add(1, std::memory_order_relaxed);
+					return true;
+				}
+			}
+			// The compare-and-swap failed because another thread took this slot, which is now in slot_first_word.
+		}
+
+		while (slot_first_word == claimed_word)
+		{
+			slot_first_word = slot.first_word.load(std::memory_order_acquire);
+		}
+
+		if (slot_first_word == first_word && has_other_words(slot, state_key))
+		{
+			return false;
+		}
+	}
+}
+
+
+bool ConcurrentStateSet::is_full(void) const
+{
+	return count.load(std::memory_order_relaxed) >= slot_count / 2;
+}
+
+
+std::size_t ConcurrentStateSet::size(void) const
+{
+	const std::lock_guard<std::mutex> lock(reserved_first_word_keys_mutex);
+	return count.load(std::memory_order_relaxed) + reserved_first_word_keys.size();
+}
+
+
+std::size_t ConcurrentStateSet::capacity(void) const
+{
+	return slot_count;
+}
+
+
+std::size_t ConcurrentStateSet::get_start_slot_index(const state_key_t &state_key) const
+{
+	return StateKey::HashFunction()(state_key) & slot_index_mask;
+}
+
+
+bool ConcurrentStateSet::has_other_words(const Slot &slot, const state_key_t &state_key) const
+{
+	for (std::size_t word_index = 1; word_index < state_key_words; ++word_index)
+	{
+		if (slot.other_words[word_index - 1] != state_key.words[word_index])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+void ConcurrentStateSet::rehash(const std::size_t new_capacity)
+{
+	std::unique_ptr<Slot[]> old_slots = std::make_unique<Slot[]>(new_capacity);
+	old_slots.swap(slots);
+
+	const std::size_t old_slot_count = slot_count;
+
+	slot_count = new_capacity;
+	slot_index_mask = new_capacity - 1;
+
+	for (std::size_t slot_index = 0; slot_index < slot_count; ++slot_index)
+	{
+		slots[slot_index].first_word.store(empty_word, std::memory_order_relaxed);
+	}
+
+	// Every key is known to be unique, so there's no need to compare against the occupied slots.
+	for (std::size_t old_slot_index = 0; old_slot_index < old_slot_count; ++old_slot_index)
+	{
+		const Slot &old_slot = old_slots[old_slot_index];
+
+		const uint64_t old_first_word = old_slot.first_word.load(std::memory_order_relaxed);
+
+		if (old_first_word == empty_word)
+		{
+			continue;
+		}
+
+		state_key_t state_key;
+		state_key.words[0] = old_first_word;
+
+		for (std::size_t word_index = 1; word_index < state_key_words; ++word_index)
+		{
+			state_key.words[word_index] = old_slot.other_words[word_index - 1];
+		}
+
+		std::size_t slot_index = get_start_slot_index(state_key);
+
+		while (slots[slot_index].first_word.load(std::memory_order_relaxed) != empty_word)
+		{
+			slot_index = (slot_index + 1) & slot_index_mask;
+		}
+
+		slots[slot_index].first_word.store(old_first_word, std::memory_order_relaxed);
+		slots[slot_index].other_words = old_slot.other_words;
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+#include "flat_state_set.hpp"
+
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+
+
+/*
+An insert-only open addressing hash set of state keys that many threads can insert into without locking.
+Single word keys are claimed with a single compare-and-swap on the slot.
+Wider keys claim the slot's first word first, write the other words and then publish the first word,
+so a thread that finds a claimed slot only waits for those few stores.
+
+The capacity can't change while threads are inserting, so inserters check is_full() first
+and hold on to the states they couldn't insert until reserve() has been called again.
+*/
+class ConcurrentStateSet
+{
+public:
+	ConcurrentStateSet(void);
+
+	// Not thread-safe, so only call this while no thread is inserting.
+	void reserve(const std::size_t expected_state_count);
+
+	bool insert(const state_key_t &state_key);
+	bool is_full(void) const;
+
+	std::size_t size(void) const;
+	std::size_t capacity(void) const;
+
+private:
+	static std::size_t constexpr minimum_capacity = 1 << 16;
+
+	static uint64_t constexpr empty_word = ~uint64_t(0);
+	static uint64_t constexpr claimed_word = ~uint64_t(1);
+
+	struct Slot
+	{
+		std::atomic<uint64_t> first_word;
+		std::array<uint64_t, state_key_words - 1> other_words;
+	};
+
+	std::size_t get_start_slot_index(const state_key_t &state_key) const;
+	bool has_other_words(const Slot &slot, const state_key_t &state_key) const;
+	void rehash(const std::size_t new_capacity);
+
+	std::unique_ptr<Slot[]> slots;
+	std::size_t slot_count;
+	std::size_t slot_index_mask;
+
+	std::atomic<std::size_t> count;
+
+	/*
+	Keys whose first word is empty_word or claimed_word can't be told apart from a free or claimed slot, so they're kept here instead.
+	The pieces packed into a full first word would share a cell, so real states never end up here and the mutex is never contended.
+	*/
+	FlatStateSet reserved_first_word_keys;
+	mutable std::mutex reserved_first_word_keys_mutex;
+};
@@ -0,0 +1,149 @@
+#include "flat_state_set.hpp"
+
+
+FlatStateSet::FlatStateSet(void)
+	: slots(minimum_capacity, get_empty_key()), slot_index_mask(minimum_capacity - 1), count(0), contains_empty_key(false)
+{
+}
+
+
+void FlatStateSet::reserve(const std::size_t expected_state_count)
+{
+	std::size_t new_capacity = slots.size();
+
+	// Keeps the load factor of the expected state count at or below the growth threshold.
+	while (new_capacity / 4 * 3 < expected_state_count)
+	{
+		new_capacity *= 2;
+	}
+
+	if (new_capacity != slots.size())
+	{
+		rehash(new_capacity);
+	}
+}
+
+
+bool FlatStateSet::insert(const state_key_t &state_key)
+{
+	static const state_key_t empty_key = get_empty_key();
+
+	if (state_key == empty_key)
+	{
+		const bool inserted = !contains_empty_key;
+		contains_empty_key = true;
+		return inserted;
+	}
+
+	if (is_too_full())
+	{
+		rehash(slots.size() * 2);
+	}
+
+	for (std::size_t slot_index = get_start_slot_index(state_key); ; slot_index = (slot_index + 1) & slot_index_mask)
+	{
+		state_key_t &slot = slots[slot_index];
+
+		if (slot == state_key)
+		{
+			return false;
+		}
+
+		if (slot == empty_key)
+		{
+			slot = state_key;
+			count++;
+			return true;
+		}
+	}
+}
+
+
+bool FlatStateSet::contains(const state_key_t &state_key) const
+{
+	static const state_key_t empty_key = get_empty_key();
+
+	if (state_key == empty_key)
+	{
+		return contains_empty_key;
+	}
+
+	for (std::size_t slot_index = get_start_slot_index(state_key); ; slot_index = (slot_index + 1) & slot_index_mask)
+	{
+		const state_key_t &slot = slots[slot_index];
+
+		if (slot == state_key)
+		{
+			return true;
+		}
+
+		if (slot == empty_key)
+		{
+			return false;
+		}
+	}
+}
+
+
+std::size_t FlatStateSet::size(void) const
+{
+	return count + contains_empty_key;
+}
+
+
+std::size_t FlatStateSet::capacity(void) const
+{
+	return slots.size();
+}
+
+
+state_key_t FlatStateSet::get_empty_key(void)
+{
+	state_key_t empty_key;
+
+	empty_key.words.fill(~uint64_t(0));
+
+	return empty_key;
+}
+
+
+std::size_t FlatStateSet::get_start_slot_index(const state_key_t &state_key) const
+{
+	return StateKey::HashFunction()(state_key) & slot_index_mask;
+}
+
+
+void FlatStateSet::rehash(const std::size_t new_capacity)
+{
+	const state_key_t empty_key = get_empty_key();
+
+	std::vector<state_key_t> old_slots(new_capacity, empty_key);
+	old_slots.swap(slots);
+
+	slot_index_mask = new_capacity - 1;
+
+	// Every key is known to be unique, so there's no need to compare against the occupied slots.
+	for (const auto &old_slot : old_slots)
+	{
+		if (old_slot == empty_key)
+		{
+			continue;
+		}
+
+		std::size_t slot_index = get_start_slot_index(old_slot);
+
+		while (!(slots[slot_index] == empty_key))
+		{
+			slot_index = (slot_index + 1) & slot_index_mask;
+		}
+
+		slots[slot_index] = old_slot;
+	}
+}
+
+
+bool FlatStateSet::is_too_full(void) const
+{
+	// A maximum load factor of 3/4 keeps linear probe sequences short.
+	return (count + 1) > slots.size() / 4 * 3;
+}
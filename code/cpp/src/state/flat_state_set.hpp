@@ -0,0 +1,65 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+
+
+#include <vector>
+#include <cstddef>
+
+
+/*
+An insert-only open addressing hash set of state keys.
+The BFS never forgets a state, so there are no tombstones to worry about,
+and the keys are stored inline so a lookup touches a single cache line most of the time.
+*/
+class FlatStateSet
+{
+public:
+	FlatStateSet(void);
+
+	void reserve(const std::size_t expected_state_count);
+
+	bool insert(const state_key_t &state_key);
+	bool contains(const state_key_t &state_key) const;
+
+	std::size_t size(void) const;
+	std::size_t capacity(void) const;
+
+	// Calls the function with every key in the set, in no particular order, without allocating anything.
+	template <typename Function>
+	void for_each(Function function) const
+	{
+		const state_key_t empty_key = get_empty_key();
+
+		for (const auto &slot : slots)
+		{
+			if (!(slot == empty_key))
+			{
+				function(slot);
+			}
+		}
+
+		if (contains_empty_key)
+		{
+			function(empty_key);
+		}
+	}
+
+private:
+	static std::size_t constexpr minimum_capacity = 1024;
+
+	// A key with every bit set would need every piece to be on the very last cell, so it can't be a real state.
+	static state_key_t get_empty_key(void);
+
+	std::size_t get_start_slot_index(const state_key_t &state_key) const;
+	void rehash(const std::size_t new_capacity);
+	bool is_too_full(void) const;
+
+	std::vector<state_key_t> slots;
+	std::size_t slot_index_mask;
+	std::size_t count;
+
+	// Handles the pathological puzzle where a single 1x1 piece can actually reach the last cell.
+	bool contains_empty_key;
+};
@@ -0,0 +1,44 @@
+#include "sharded_state_set.hpp"
+
+
+void ShardedStateSet::reserve(const std::size_t expected_state_count)
+{
+	for (auto &shard : shards)
+	{
+		const std::lock_guard<std::mutex> lock(shard.mutex);
+
+		shard.states.reserve(expected_state_count / shard_count);
+	}
+}
+
+
+bool ShardedStateSet::insert(const state_key_t &state_key)
+{
+	Shard &shard = shards[get_shard_index(state_key)];
+
+	const std::lock_guard<std::mutex> lock(shard.mutex);
+
+	return shard.states.insert(state_key);
+}
+
+
+std::size_t ShardedStateSet::size(void)
+{
+	std::size_t size = 0;
+
+	for (auto &shard : shards)
+	{
+		const std::lock_guard<std::mutex> lock(shard.mutex);
+
+		size += shard.states.size();
+	}
+
+	return size;
+}
+
+
+std::size_t ShardedStateSet::get_shard_index(const state_key_t &state_key) const
+{
+	// FlatStateSet picks slots with the low bits of the hash, so the shard is picked with the high bits.
+	return StateKey::HashFunction()(state_key) >> (64 - shard_count_bits);
+}
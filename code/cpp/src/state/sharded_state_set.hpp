@@ -0,0 +1,38 @@
+#pragma once
+
+
+#include "flat_state_set.hpp"
+
+
+#include <array>
+#include <mutex>
+
+
+/*
+A FlatStateSet per shard, each behind its own mutex,
+so threads inserting different states rarely wait on each other.
+*/
+class ShardedStateSet
+{
+public:
+	void reserve(const std::size_t expected_state_count);
+
+	bool insert(const state_key_t &state_key);
+
+	std::size_t size(void);
+
+private:
+	static int constexpr shard_count_bits = 6;
+	static std::size_t constexpr shard_count = std::size_t(1) << shard_count_bits;
+
+	// Aligned so that two shards' mutexes never share a cache line.
+	struct alignas(64) Shard
+	{
+		std::mutex mutex;
+		FlatStateSet states;
+	};
+
+	std::size_t get_shard_index(const state_key_t &state_key) const;
+
+	std::array<Shard, shard_count> shards;
+};
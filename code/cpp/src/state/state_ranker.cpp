@@ -0,0 +1,331 @@
+#include "state_ranker.hpp"
+
+#include "../sliding_puzzle_solver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+
+void StateRanker::initialize(void)
+{
+	const int cell_count = sps.width * sps.height;
+
+	piece_class_indices.assign(sps.pieces_count, std::numeric_limits<std::size_t>::max());
+	class_piece_indices.clear();
+
+	for (const auto &identical_pieces : sps.identical_piece_classes)
+	{
+		for (const auto piece_index : identical_pieces)
+		{
+			piece_class_indices[piece_index] = class_piece_indices.size();
+		}
+
+		class_piece_indices.push_back(identical_pieces);
+	}
+
+	for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+	{
+		if (piece_class_indices[piece_index] == std::numeric_limits<std::size_t>::max())
+		{
+			piece_class_indices[piece_index] = class_piece_indices.size();
+			class_piece_indices.push_back({piece_index});
+		}
+	}
+
+	class_count = class_piece_indices.size();
+	step_count = cell_count * class_count;
+
+	class_cell_masks.assign(class_count, 0);
+	can_place_class.assign(class_count, std::vector<bool>(cell_count, false));
+	class_radices.assign(class_count, 0);
+
+	left_counts_radix = 1;
+	starting_left_counts = 0;
+
+	for (std::size_t class_index = 0; class_index < class_count; ++class_index)
+	{
+		const cell_id piece_index = class_piece_indices[class_index][0];
+
+		for (const auto &rect : sps.starting_pieces_info[piece_index].rects)
+		{
+			for (int y = rect.offset.y; y < rect.offset.y + rect.size.height; ++y)
+			{
+				for (int x = rect.offset.x; x < rect.offset.x + rect.size.width; ++x)
+				{
+					const int cell_offset = x + y * sps.width;
+
+					if (cell_offset >= 64)
+					{
+						throw std::invalid_argument("Ranking states needs every cell of a piece to be less than 64 cells after its top-left cell");
+					}
+
+					class_cell_masks[class_index] |= uint64_t(1) << cell_offset;
+				}
+			}
+		}
+
+		for (const auto cell_index : sps.get_wall_free_cell_indices(piece_index))
+		{
+			can_place_class[class_index][cell_index] = true;
+		}
+
+		const uint64_t class_size = class_piece_indices[class_index].size();
+
+		if (left_counts_radix > std::numeric_limits<uint64_t>::max() / (class_size + 1))
+		{
+			throw std::overflow_error("The puzzle has too many pieces to rank its states");
+		}
+
+		class_radices[class_index] = left_counts_radix;
+		starting_left_counts += class_size * left_counts_radix;
+		left_counts_radix *= class_size + 1;
+	}
+
+	if (left_counts_radix > std::numeric_limits<uint64_t>::max() / (step_count + 1))
+	{
+		throw std::overflow_error("The puzzle has too many pieces to rank its states");
+	}
+
+	completion_counts.clear();
+
+	state_count = count_completions(0, starting_left_counts, 0);
+
+	std::size_t slot_count = 1;
+
+	while (slot_count < 2 * completion_counts.size())
+	{
+		slot_count *= 2;
+	}
+
+	completion_count_slots.assign(slot_count, {{0, empty_step_and_left_counts}, 0});
+	slot_index_mask = slot_count - 1;
+
+	for (const auto &[point, completion_count] : completion_counts)
+	{
+		std::size_t slot_index = Point::HashFunction()(point) & slot_index_mask;
+
+		while (completion_count_slots[slot_index].point.step_and_left_counts != empty_step_and_left_counts)
+		{
+			slot_index = (slot_index + 1) & slot_index_mask;
+		}
+
+		completion_count_slots[slot_index] = {point, completion_count};
+	}
+
+	completion_counts = {};
+}
+
+
+uint64_t StateRanker::get_state_count(void) const
+{
+	return state_count;
+}
+
+
+uint64_t StateRanker::get_rank(const pieces_t &pieces) const
+{
+	std::array<std::size_t, SlidingPuzzleSolver::piece_labels.length()> placement_steps;
+
+	for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+	{
+		const Pos &top_left = pieces[piece_index].top_left;
+
+		placement_steps[piece_index] = (top_left.x + top_left.y * sps.width) * class_count + piece_class_indices[piece_index];
+	}
+
+	std::sort(placement_steps.begin(), placement_steps.begin() + sps.pieces_count);
+
+	uint64_t rank = 0;
+	uint64_t left_counts = starting_left_counts;
+	uint64_t taken_cells = 0;
+	std::size_t step = 0;
+
+	// Skipping the steps in between means not placing anything there, which doesn't add to the rank.
+	for (cell_id placement_index = 0; placement_index != sps.pieces_count; ++placement_index)
+	{
+		const std::size_t placement_step = placement_steps[placement_index];
+		const std::size_t skipped_cell_count = placement_step / class_count - step / class_count;
+
+		taken_cells = skipped_cell_count < 64 ? taken_cells >> skipped_cell_count : 0;
+		step = placement_step;
+
+		if (!can_place(step, left_counts, taken_cells))
+		{
+			throw std::invalid_argument("Only placements whose pieces don't overlap each other or the walls can be ranked");
+		}
+
+		rank += get_completion_count(step + 1, left_counts, get_next_taken_cells(step, taken_cells));
+
+		const std::size_t class_index = step % class_count;
+
+		left_counts -= class_radices[class_index];
+		taken_cells = get_next_taken_cells(step, taken_cells | class_cell_masks[class_index]);
+		step++;
+	}
+
+	return rank;
+}
+
+
+uint64_t StateRanker::get_visited_rank(const pieces_t &pieces, pieces_t &mirrored_pieces, bool &is_mirrored) const
+{
+	const uint64_t rank = get_rank(pieces);
+
+	is_mirrored = false;
+
+	if (!sps.is_mirror_symmetric)
+	{
+		return rank;
+	}
+
+	sps.set_mirrored_pieces(mirrored_pieces, pieces);
+
+	const uint64_t mirrored_rank = get_rank(mirrored_pieces);
+
+	if (mirrored_rank < rank)
+	{
+		is_mirrored = true;
+		return mirrored_rank;
+	}
+
+	return rank;
+}
+
+
+void StateRanker::set_pieces_from_rank(pieces_t &pieces, uint64_t rank) const
+{
+	if (rank >= state_count)
+	{
+		throw std::out_of_range("The rank " + std::to_string(rank) + " isn't below the number of placements");
+	}
+
+	std::array<std::size_t, SlidingPuzzleSolver::piece_labels.length()> class_placed_counts = {};
+
+	uint64_t left_counts = starting_left_counts;
+	uint64_t taken_cells = 0;
+
+	std::size_t step = 0;
+
+	// This walks through every step, so it keeps track of the cell and class instead of dividing the step.
+	for (int cell_index = 0; left_counts != 0; ++cell_index)
+	{
+		for (std::size_t class_index = 0; class_index < class_count; ++class_index, ++step)
+		{
+			if (class_placed_counts[class_index] == class_piece_indices[class_index].size() || !can_place_class[class_index][cell_index] || (taken_cells & class_cell_masks[class_index]) != 0)
+			{
+				continue;
+			}
+
+			const bool is_last_class = class_index == class_count - 1;
+
+			// All placements that don't place a piece here come first.
+			const uint64_t skipped_count = get_completion_count(step + 1, left_counts, is_last_class ? taken_cells >> 1 : taken_cells);
+
+			if (rank >= skipped_count)
+			{
+				rank -= skipped_count;
+
+				const cell_id piece_index = class_piece_indices[class_index][class_placed_counts[class_index]++];
+				pieces[piece_index].top_left = {cell_index % sps.width, cell_index / sps.width};
+
+				left_counts -= class_radices[class_index];
+				taken_cells |= class_cell_masks[class_index];
+			}
+		}
+
+		taken_cells >>= 1;
+	}
+}
+
+
+uint64_t StateRanker::count_completions(const std::size_t step, const uint64_t left_counts, const uint64_t taken_cells)
+{
+	if (left_counts == 0)
+	{
+		return 1;
+	}
+
+	if (step == step_count)
+	{
+		return 0;
+	}
+
+	const Point point = {taken_cells, step * left_counts_radix + left_counts};
+
+	const auto completion_count_iterator = completion_counts.find(point);
+
+	if (completion_count_iterator != completion_counts.end())
+	{
+		return completion_count_iterator->second;
+	}
+
+	uint64_t completion_count = count_completions(step + 1, left_counts, get_next_taken_cells(step, taken_cells));
+
+	if (can_place(step, left_counts, taken_cells))
+	{
+		const std::size_t class_index = step % class_count;
+
+		const uint64_t placed_completion_count = count_completions(step + 1, left_counts - class_radices[class_index], get_next_taken_cells(step, taken_cells | class_cell_masks[class_index]));
+
+		if (placed_completion_count > std::numeric_limits<uint64_t>::max() - completion_count)
+		{
+			throw std::overflow_error("The puzzle has too many placements to rank its states");
+		}
+
+		completion_count += placed_completion_count;
+	}
+
+	completion_counts.emplace(point, completion_count);
+
+	return completion_count;
+}
+
+
+// Only looks up what count_completions() counted, so it can be called from several threads at once.
+uint64_t StateRanker::get_completion_count(const std::size_t step, const uint64_t left_counts, const uint64_t taken_cells) const
+{
+	if (left_counts == 0)
+	{
+		return 1;
+	}
+
+	if (step == step_count)
+	{
+		return 0;
+	}
+
+	const Point point = {taken_cells, step * left_counts_radix + left_counts};
+
+	for (std::size_t slot_index = Point::HashFunction()(point) & slot_index_mask; ; slot_index = (slot_index + 1) & slot_index_mask)
+	{
+		const CompletionCountSlot &slot = completion_count_slots[slot_index];
+
+		if (slot.point == point)
+		{
+			return slot.completion_count;
+		}
+
+		if (slot.point.step_and_left_counts == empty_step_and_left_counts)
+		{
+			throw std::logic_error("A placement that was ranked wasn't counted");
+		}
+	}
+}
+
+
+bool StateRanker::can_place(const std::size_t step, const uint64_t left_counts, const uint64_t taken_cells) const
+{
+	const std::size_t class_index = step % class_count;
+	const std::size_t class_left_count = left_counts / class_radices[class_index] % (class_piece_indices[class_index].size() + 1);
+
+	return class_left_count != 0 && can_place_class[class_index][step / class_count] && (taken_cells & class_cell_masks[class_index]) == 0;
+}
+
+
+// Moving on to the next cell shifts its bit into the lowest one.
+uint64_t StateRanker::get_next_taken_cells(const std::size_t step, const uint64_t taken_cells) const
+{
+	return step % class_count == class_count - 1 ? taken_cells >> 1 : taken_cells;
+}
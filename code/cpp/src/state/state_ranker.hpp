@@ -0,0 +1,112 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+#include "../pieces.hpp"
+
+
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+
+class SlidingPuzzleSolver;
+
+/*
+Numbers every placement of the pieces on the board from 0 up to the number of placements,
+so the visited states can be a bit array, and everything else that is known about a state an array indexed by its rank.
+Swapping two identical pieces doesn't change the rank, but mirroring the state does.
+
+The placements are ordered by walking through the cells and, for every cell, through the classes of identical pieces,
+with not placing a piece of the class there coming first.
+How many placements can still be completed is counted for every point of that walk,
+which only depends on how many pieces of every class are left and on which of the next few cells are taken.
+*/
+class StateRanker
+{
+public:
+	StateRanker(SlidingPuzzleSolver &sps_) : sps(sps_) {};
+
+	// Counts the placements, which has to happen before anything else.
+	void initialize(void);
+
+	uint64_t get_state_count(void) const;
+
+	// The pieces can be in any order, but have to be a placement that doesn't overlap itself or the walls.
+	uint64_t get_rank(const pieces_t &pieces) const;
+
+	// The lower rank of the state and its mirror image, if the puzzle is mirror symmetric, which sets the mirrored pieces.
+	uint64_t get_visited_rank(const pieces_t &pieces, pieces_t &mirrored_pieces, bool &is_mirrored) const;
+
+	// Identical pieces are given their top-lefts in increasing cell order.
+	void set_pieces_from_rank(pieces_t &pieces, uint64_t rank) const;
+
+	// The index of the class a piece belongs to, and the pieces of every class in increasing order.
+	std::vector<std::size_t> piece_class_indices;
+	std::vector<std::vector<cell_id>> class_piece_indices;
+
+private:
+	// The walk's position and the number of pieces left of every class, packed as a mixed-radix number.
+	struct Point
+	{
+		// The cells from the current one on that are taken by the pieces placed so far, with the current cell in the lowest bit.
+		uint64_t taken_cells;
+		uint64_t step_and_left_counts;
+
+		bool operator==(const Point &other) const
+		{
+			return taken_cells == other.taken_cells && step_and_left_counts == other.step_and_left_counts;
+		}
+		struct HashFunction {
+			size_t operator() (const Point &point) const
+			{
+				StateKey state_key = {};
+				state_key.words[0] = point.taken_cells ^ (point.step_and_left_counts * 0x9e3779b97f4a7c15ULL);
+
+				return StateKey::HashFunction()(state_key);
+			}
+		};
+	};
+
+	struct CompletionCountSlot
+	{
+		Point point;
+		uint64_t completion_count;
+	};
+
+	uint64_t count_completions(const std::size_t step, const uint64_t left_counts, const uint64_t taken_cells);
+	uint64_t get_completion_count(const std::size_t step, const uint64_t left_counts, const uint64_t taken_cells) const;
+	bool can_place(const std::size_t step, const uint64_t left_counts, const uint64_t taken_cells) const;
+	uint64_t get_next_taken_cells(const std::size_t step, const uint64_t taken_cells) const;
+
+	SlidingPuzzleSolver &sps;
+
+	std::size_t class_count;
+
+	// A step is a cell index times the class count plus a class index.
+	std::size_t step_count;
+
+	// Indexed by class, these are the bits of the cells a piece takes up relative to its top-left cell.
+	std::vector<uint64_t> class_cell_masks;
+
+	// Indexed by class and then by cell index, whether a piece of the class fits on the board with its top-left there.
+	std::vector<std::vector<bool>> can_place_class;
+
+	// Indexed by class, what one piece of the class is worth in the packed left counts.
+	std::vector<uint64_t> class_radices;
+	uint64_t left_counts_radix;
+
+	uint64_t starting_left_counts;
+
+	uint64_t state_count;
+
+	// Only used while counting, after which the counts are moved into the open addressing slots, which are quicker to look up.
+	std::unordered_map<Point, uint64_t, Point::HashFunction> completion_counts;
+
+	// Packed steps and left counts are all below the step count times the left counts radix, which initialize() makes sure fits.
+	static uint64_t constexpr empty_step_and_left_counts = ~uint64_t(0);
+
+	std::vector<CompletionCountSlot> completion_count_slots;
+	std::size_t slot_index_mask;
+};
@@ -0,0 +1,71 @@
+#include "transposition_table.hpp"
+
+
+void TranspositionTable::resize(const std::size_t megabytes)
+{
+	const std::size_t max_entry_count = megabytes * 1024 * 1024 / sizeof(Entry);
+
+	// The entry count is rounded down to a power of two, so the hash can be masked instead of taken modulo.
+	std::size_t entry_count = 1;
+
+	while (entry_count * 2 <= max_entry_count)
+	{
+		entry_count *= 2;
+	}
+
+	entries.assign(entry_count, {});
+	entry_index_mask = entry_count - 1;
+
+	iteration = 0;
+}
+
+
+void TranspositionTable::start_iteration(void)
+{
+	iteration++;
+}
+
+
+bool TranspositionTable::visit(const state_key_t &state_key, const int path_length)
+{
+	Entry &entry = entries[StateKey::HashFunction()(state_key) & entry_index_mask];
+
+	if (entry.iteration == iteration)
+	{
+		if (entry.state_key == state_key)
+		{
+			if (entry.path_length <= path_length)
+			{
+				return false;
+			}
+
+			entry.path_length = path_length;
+
+			return true;
+		}
+
+		// Replace-by-depth: the state that was reached by the longer path has the smaller subtree left, so it gets forgotten.
+		if (entry.path_length < path_length)
+		{
+			return true;
+		}
+	}
+
+	entry = {state_key, iteration, static_cast<uint16_t>(path_length)};
+
+	stored_count++;
+
+	return true;
+}
+
+
+std::size_t TranspositionTable::get_stored_count(void) const
+{
+	return stored_count;
+}
+
+
+std::size_t TranspositionTable::capacity(void) const
+{
+	return entries.size();
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+
+#include "../typedefs.hpp"
+
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+
+/*
+A fixed-size, direct-mapped table that remembers the shortest path length every state was reached with during the current IDA* iteration.
+Reaching a state again by a path that isn't shorter can't find anything new, which also cuts off cycles.
+
+Two states that land in the same slot fight over it, and the one reached by the shorter path wins,
+as its subtree is the bigger one to not search twice. Entries from earlier iterations always lose.
+*/
+class TranspositionTable
+{
+public:
+	void resize(const std::size_t megabytes);
+	void start_iteration(void);
+
+	// Returns false if the state was already reached by a path of at most this length this iteration, and otherwise remembers it.
+	bool visit(const state_key_t &state_key, const int path_length);
+
+	// The number of times a state was written into a slot.
+	std::size_t get_stored_count(void) const;
+	std::size_t capacity(void) const;
+
+private:
+	struct Entry
+	{
+		state_key_t state_key;
+
+		// Zero for empty slots, as the first iteration is one.
+		uint32_t iteration;
+		uint16_t path_length;
+	};
+
+	std::vector<Entry> entries;
+	std::size_t entry_index_mask = 0;
+
+	uint32_t iteration = 0;
+
+	std::size_t stored_count = 0;
+};
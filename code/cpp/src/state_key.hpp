@@ -0,0 +1,58 @@
+#pragma once
+
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+
+// Puzzles whose packed positions don't fit in one word can be solved by building with "make STATE_KEY_WORDS=2".
+#ifndef STATE_KEY_WORDS
+# define STATE_KEY_WORDS 1
+#endif
+
+
+static std::size_t constexpr state_key_words = STATE_KEY_WORDS;
+static std::size_t constexpr state_key_word_bits = 64;
+
+
+/*
+Every piece's top-left is stored as the cell index "x + y * width",
+using just enough bits to hold the largest cell index of the board.
+A piece is never split across two words.
+*/
+struct StateKey
+{
+	std::array<uint64_t, state_key_words> words;
+
+	bool operator==(const StateKey &other) const
+	{
+		return words == other.words;
+	}
+	bool operator<(const StateKey &other) const
+	{
+		return words < other.words;
+	}
+	struct HashFunction {
+		// The finalizer of MurmurHash3, which is plenty for keys that are already dense bit patterns.
+		size_t operator() (const StateKey &state_key) const
+		{
+			uint64_t seed = 0;
+
+			for (const auto word : state_key.words)
+			{
+				uint64_t hash = word ^ seed;
+
+				hash ^= hash >> 33;
+				hash *= 0xff51afd7ed558ccdULL;
+				hash ^= hash >> 33;
+				hash *= 0xc4ceb9fe1a85ec53ULL;
+				hash ^= hash >> 33;
+
+				seed = hash;
+			}
+
+			return seed;
+		}
+	};
+};
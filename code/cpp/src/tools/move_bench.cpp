@@ -0,0 +1,358 @@
+#include "../sliding_puzzle_solver.hpp"
+
+
+#include <cmath>
+#include <functional>
+
+
+/*
+Times the pieces of the move generation hot path one at a time, on states recorded from a BFS of a real puzzle,
+so a change to the hashing or the board layout can be judged in seconds instead of by timing a whole solve.
+
+Every benchmark makes a couple of untimed warmup passes over all recorded states, and then times every pass after that.
+The median time per operation is what to compare, while the spread says how much to trust it.
+
+Usage: move_bench [puzzle name] [recorded state count]
+*/
+
+
+static int constexpr warmup_pass_count = 3;
+static int constexpr timed_pass_count = 25;
+
+
+struct Benchmark
+{
+	std::string name;
+
+	// Runs outside of the timing before every pass, to undo what the previous pass changed.
+	std::function<void(void)> reset;
+
+	// Returns the number of operations it did.
+	std::function<uint64_t(void)> run_pass;
+};
+
+
+// Reaches into the private parts of the solver, as the hot path is mostly private.
+struct MoveBench
+{
+	MoveBench(SlidingPuzzleSolver &sps_, const std::size_t state_count) : sps(sps_)
+	{
+		record_states(state_count);
+	}
+
+	std::vector<Benchmark> get_benchmarks(void);
+
+	SlidingPuzzleSolver &sps;
+
+	// The first states a BFS from the starting state visits, in the order it visits them.
+	std::vector<pieces_t> recorded_pieces;
+	std::vector<state_key_t> recorded_state_keys;
+	std::vector<cells_t> recorded_cells;
+	std::vector<Bitboard> recorded_bitboards;
+
+	// The valid moves of the recorded states, so timing the moves doesn't also time finding them.
+	struct ValidMove
+	{
+		uint32_t state_index;
+		cell_id piece_index;
+		piece_direction direction;
+	};
+
+	std::vector<ValidMove> valid_moves;
+
+	// Keeps the compiler from leaving out work whose result isn't used otherwise.
+	uint64_t checksum = 0;
+
+private:
+	void record_states(const std::size_t state_count);
+};
+
+
+void MoveBench::record_states(const std::size_t state_count)
+{
+	FlatStateSet visited_states;
+	std::vector<state_key_t> queue;
+
+	const pieces_t starting_pieces = sps.get_starting_pieces();
+	const state_key_t starting_state_key = sps.get_state_key(starting_pieces);
+
+	visited_states.insert(sps.get_visited_state_key(starting_state_key));
+	queue.push_back(starting_state_key);
+
+	pieces_t pieces = starting_pieces;
+	Bitboard bitboard;
+
+	for (std::size_t queue_index = 0; queue_index < queue.size() && recorded_pieces.size() < state_count; ++queue_index)
+	{
+		sps.set_pieces_from_state_key(pieces, queue[queue_index]);
+
+		recorded_pieces.push_back(pieces);
+		recorded_state_keys.push_back(queue[queue_index]);
+
+		cells_t cells;
+		sps.set_board_from_pieces(cells, pieces);
+		recorded_cells.push_back(cells);
+
+		sps.set_board_from_pieces(bitboard, pieces);
+		recorded_bitboards.push_back(bitboard);
+
+		for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+		{
+			Pos &piece_top_left = pieces[piece_index].top_left;
+
+			for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+			{
+				if (sps.cant_move(piece_top_left, piece_index, direction, bitboard))
+				{
+					continue;
+				}
+
+				valid_moves.push_back({static_cast<uint32_t>(queue_index), piece_index, direction});
+
+				sps.move(piece_top_left, piece_index, direction, bitboard);
+
+				const state_key_t state_key = sps.get_state_key(pieces);
+
+				if (visited_states.insert(sps.get_visited_state_key(state_key)))
+				{
+					queue.push_back(state_key);
+				}
+
+				sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), bitboard);
+			}
+		}
+	}
+}
+
+
+std::vector<Benchmark> MoveBench::get_benchmarks(void)
+{
+	const auto no_reset = [](){};
+
+	// Every direction of every piece of every state.
+	const auto run_cant_move_pass = [this](auto &boards)
+	{
+		uint64_t operation_count = 0;
+		uint64_t blocked_count = 0;
+
+		for (std::size_t state_index = 0; state_index < recorded_pieces.size(); ++state_index)
+		{
+			pieces_t &pieces = recorded_pieces[state_index];
+
+			for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+			{
+				for (piece_direction direction = 0; direction < sps.direction_count; ++direction)
+				{
+					blocked_count += sps.cant_move(pieces[piece_index].top_left, piece_index, direction, boards[state_index]);
+					operation_count++;
+				}
+			}
+		}
+
+		checksum += blocked_count;
+
+		return operation_count;
+	};
+
+	// Every valid move of every state, and moving back again, which both count.
+	const auto run_move_pass = [this](auto &boards)
+	{
+		for (const auto &[state_index, piece_index, direction] : valid_moves)
+		{
+			Pos &piece_top_left = recorded_pieces[state_index][piece_index].top_left;
+			auto &board = boards[state_index];
+
+			sps.move(piece_top_left, piece_index, direction, board);
+			checksum += piece_top_left.x;
+			sps.move(piece_top_left, piece_index, sps.get_inverted_direction(direction), board);
+		}
+
+		return valid_moves.size() * 2;
+	};
+
+	// Empties the cells every valid move empties and fills them with the piece again, which both count.
+	const auto run_apply_offsets_to_cells_pass = [this]()
+	{
+		for (const auto &[state_index, piece_index, direction] : valid_moves)
+		{
+			Pos &piece_top_left = recorded_pieces[state_index][piece_index].top_left;
+			cells_t &cells = recorded_cells[state_index];
+
+			const auto &offsets = sps.emptied_offsets.pieces[piece_index].directions[direction].offsets;
+
+			sps.apply_offsets_to_cells(cells, piece_top_left, offsets, SlidingPuzzleSolver::empty_cell_id);
+			checksum += cells[piece_top_left.y][piece_top_left.x];
+			sps.apply_offsets_to_cells(cells, piece_top_left, offsets, piece_index);
+		}
+
+		return valid_moves.size() * 2;
+	};
+
+	const auto run_get_state_key_pass = [this]()
+	{
+		for (const auto &pieces : recorded_pieces)
+		{
+			checksum += sps.get_state_key(pieces).words[0];
+		}
+
+		return recorded_pieces.size();
+	};
+
+	const auto run_hash_pass = [this]()
+	{
+		const StateKey::HashFunction hash_function;
+
+		for (const auto &state_key : recorded_state_keys)
+		{
+			checksum += hash_function(state_key);
+		}
+
+		return recorded_state_keys.size();
+	};
+
+	// Starts out empty every pass, with room for the states the recorded states lead to, like the BFS reserves room for the expected states.
+	const auto reset_states = [this]()
+	{
+		sps.states = states_t();
+		sps.states.reserve(recorded_state_keys.size() * sps.direction_count);
+
+		sps.state_records.clear();
+	};
+
+	// Every state is inserted twice, as the BFS finds most states again after it found them the first time.
+	const auto run_add_state_pass = [this]()
+	{
+		for (int insert_index = 0; insert_index < 2; ++insert_index)
+		{
+			for (const auto &state_key : recorded_state_keys)
+			{
+				checksum += sps.add_state(state_key);
+			}
+		}
+
+		return recorded_state_keys.size() * 2;
+	};
+
+	// Queues the new states of every recorded state, like expanding it in the BFS does.
+	const auto run_queue_valid_moves_pass = [this]()
+	{
+		pieces_queue_t pieces_queue;
+
+		pieces_t pieces = sps.get_starting_pieces();
+		board_t board;
+
+		for (std::size_t state_index = 0; state_index < recorded_pieces.size(); ++state_index)
+		{
+			pieces = recorded_pieces[state_index];
+			sps.set_board_from_pieces(board, pieces);
+
+			sps.queue_valid_moves(pieces_queue, pieces, board, state_index);
+		}
+
+		checksum += pieces_queue.size();
+
+		return recorded_pieces.size();
+	};
+
+	return {
+		{"cant_move (bitboard)", no_reset, [=, this](){ return run_cant_move_pass(recorded_bitboards); }},
+		{"cant_move (cells)", no_reset, [=, this](){ return run_cant_move_pass(recorded_cells); }},
+		{"move (bitboard)", no_reset, [=, this](){ return run_move_pass(recorded_bitboards); }},
+		{"move (cells)", no_reset, [=, this](){ return run_move_pass(recorded_cells); }},
+		{"apply_offsets_to_cells", no_reset, run_apply_offsets_to_cells_pass},
+		{"get_state_key", no_reset, run_get_state_key_pass},
+		{"StateKey::HashFunction", no_reset, run_hash_pass},
+		{"add_state", reset_states, run_add_state_pass},
+		{"queue_valid_moves", reset_states, run_queue_valid_moves_pass}
+	};
+}
+
+
+static void run_benchmark(const Benchmark &benchmark)
+{
+	std::vector<double> nanoseconds_per_operation;
+	uint64_t operation_count = 0;
+
+	for (int pass_index = 0; pass_index < warmup_pass_count + timed_pass_count; ++pass_index)
+	{
+		benchmark.reset();
+
+		const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+		operation_count = benchmark.run_pass();
+
+		const std::chrono::duration<double, std::nano> elapsed_time = std::chrono::steady_clock::now() - start_time;
+
+		if (pass_index >= warmup_pass_count)
+		{
+			nanoseconds_per_operation.push_back(elapsed_time.count() / operation_count);
+		}
+	}
+
+	std::sort(nanoseconds_per_operation.begin(), nanoseconds_per_operation.end());
+
+	const double median = nanoseconds_per_operation[timed_pass_count / 2];
+	const double minimum = nanoseconds_per_operation.front();
+
+	double mean = 0;
+
+	for (const double value : nanoseconds_per_operation)
+	{
+		mean += value / timed_pass_count;
+	}
+
+	double variance = 0;
+
+	for (const double value : nanoseconds_per_operation)
+	{
+		variance += (value - mean) * (value - mean) / (timed_pass_count - 1);
+	}
+
+	const double relative_standard_deviation = std::sqrt(variance) / mean;
+
+	std::printf("%-24s %10llu %12.2f %12.2f %9.1f%% %12.1f\n", benchmark.name.c_str(), static_cast<unsigned long long>(operation_count), median, minimum, relative_standard_deviation * 100, 1e3 / median);
+}
+
+
+int main(int argc, char *argv[])
+{
+	std::filesystem::path exe_path = argv[0];
+
+	Options options;
+
+	try
+	{
+		if (argc > 3)
+		{
+			throw std::invalid_argument("Usage: move_bench [puzzle name] [recorded state count]");
+		}
+
+		options.puzzle_name = argc > 1 ? argv[1] : "klotski";
+
+		// At least one state, as every time is divided by the number of operations on the recorded states.
+		const std::size_t state_count = argc > 2 ? get_positive_int("The recorded state count", argv[2]) : 10000;
+
+		SlidingPuzzleSolver sps(exe_path, options);
+
+		MoveBench move_bench(sps, state_count);
+
+		std::cout << "Recorded the first " << move_bench.recorded_pieces.size() << " states a BFS of " << options.puzzle_name << " visits, "
+			<< "and timed " << timed_pass_count << " passes over them after " << warmup_pass_count << " warmup passes" << std::endl << std::endl;
+
+		std::printf("%-24s %10s %12s %12s %10s %12s\n", "", "ops/pass", "median ns/op", "min ns/op", "std dev", "M ops/s");
+
+		for (const auto &benchmark : move_bench.get_benchmarks())
+		{
+			run_benchmark(benchmark);
+		}
+
+		std::cout << std::endl << "Checksum: " << move_bench.checksum << std::endl;
+	}
+	catch (const std::exception &error)
+	{
+		std::cerr << error.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
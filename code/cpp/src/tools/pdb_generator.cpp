@@ -0,0 +1,180 @@
+#include "../sliding_puzzle_solver.hpp"
+
+
+/*
+Writes a PatternDatabase for a puzzle, which "puzzle --pdb <file>" can then use as its heuristic.
+The pattern is either the given piece labels, or the ending pieces together with the pieces that start closest to them.
+Identical pieces always go into a pattern together, so the number of pieces can exceed the number of neighbours.
+
+Usage: pdb_generator --puzzle <name> --out <file> [--neighbours <n>] [--pieces <labels>]
+*/
+
+
+static int constexpr default_neighbour_count = 2;
+
+
+static std::vector<cell_id> get_pieces_from_labels(const SlidingPuzzleSolver &sps, const std::string &labels)
+{
+	std::vector<cell_id> pattern_piece_indices;
+
+	for (const char label : labels)
+	{
+		const std::size_t piece_index = sps.piece_labels.find(label);
+
+		if (piece_index == std::string_view::npos || static_cast<int>(piece_index) >= sps.pieces_count)
+		{
+			throw std::invalid_argument(std::string("The puzzle has no piece ") + label);
+		}
+
+		pattern_piece_indices.push_back(piece_index);
+	}
+
+	return pattern_piece_indices;
+}
+
+
+// The ending pieces, followed by the pieces whose starting top-lefts are closest to any ending piece's.
+// A piece brings all the pieces that are identical to it along, which don't count as neighbours of their own.
+static std::vector<cell_id> get_neighbourhood_pieces(const SlidingPuzzleSolver &sps, const int neighbour_count)
+{
+	std::vector<cell_id> pattern_piece_indices;
+	std::vector<std::pair<int, cell_id>> neighbours;
+
+	for (cell_id piece_index = 0; piece_index != sps.pieces_count; ++piece_index)
+	{
+		const Pos &top_left = sps.starting_pieces_info[piece_index].top_left;
+
+		int distance = INT_MAX;
+
+		for (const auto &ending_piece : sps.ending_pieces)
+		{
+			if (static_cast<cell_id>(ending_piece.piece_index) == piece_index)
+			{
+				distance = -1;
+				break;
+			}
+
+			const Pos &ending_piece_top_left = sps.starting_pieces_info[ending_piece.piece_index].top_left;
+
+			distance = std::min(distance, std::abs(top_left.x - ending_piece_top_left.x) + std::abs(top_left.y - ending_piece_top_left.y));
+		}
+
+		if (distance == -1)
+		{
+			pattern_piece_indices.push_back(piece_index);
+		}
+		else
+		{
+			neighbours.push_back({distance, piece_index});
+		}
+	}
+
+	std::sort(neighbours.begin(), neighbours.end());
+
+	int added_neighbour_count = 0;
+
+	for (const auto &[distance, piece_index] : neighbours)
+	{
+		if (added_neighbour_count == neighbour_count)
+		{
+			break;
+		}
+
+		if (std::find(pattern_piece_indices.cbegin(), pattern_piece_indices.cend(), piece_index) != pattern_piece_indices.cend())
+		{
+			continue;
+		}
+
+		pattern_piece_indices.push_back(piece_index);
+		added_neighbour_count++;
+
+		for (const auto &identical_pieces : sps.identical_piece_classes)
+		{
+			if (std::find(identical_pieces.cbegin(), identical_pieces.cend(), piece_index) == identical_pieces.cend())
+			{
+				continue;
+			}
+
+			for (const auto identical_piece_index : identical_pieces)
+			{
+				if (identical_piece_index != piece_index)
+				{
+					pattern_piece_indices.push_back(identical_piece_index);
+				}
+			}
+		}
+	}
+
+	return pattern_piece_indices;
+}
+
+
+int main(int argc, char *argv[])
+{
+	std::filesystem::path exe_path = argv[0];
+
+	Options options;
+	std::string out_path;
+	std::string labels;
+	int neighbour_count = default_neighbour_count;
+
+	try
+	{
+		for (int arg_index = 1; arg_index + 1 < argc; arg_index += 2)
+		{
+			const std::string arg = argv[arg_index];
+			const std::string value = argv[arg_index + 1];
+
+			if (arg == "--puzzle")
+			{
+				options.puzzle_name = value;
+			}
+			else if (arg == "--out")
+			{
+				out_path = value;
+			}
+			else if (arg == "--neighbours")
+			{
+				neighbour_count = get_positive_int(arg, value);
+			}
+			else if (arg == "--pieces")
+			{
+				labels = value;
+			}
+			else
+			{
+				throw std::invalid_argument("Unknown argument \"" + arg + "\"");
+			}
+		}
+
+		if (out_path.empty() || argc % 2 == 0)
+		{
+			throw std::invalid_argument("Usage: pdb_generator --puzzle <name> --out <file> [--neighbours <n>] [--pieces <labels>]");
+		}
+
+		SlidingPuzzleSolver sps(exe_path, options);
+
+		const std::vector<cell_id> pattern_piece_indices = labels.empty() ? get_neighbourhood_pieces(sps, neighbour_count) : get_pieces_from_labels(sps, labels);
+
+		std::cout << "Pattern pieces: ";
+		for (const auto piece_index : pattern_piece_indices)
+		{
+			std::cout << sps.piece_labels[piece_index];
+		}
+		std::cout << std::endl;
+
+		PatternDatabase pattern_database(sps);
+		pattern_database.generate(pattern_piece_indices, out_path);
+
+		const std::chrono::duration<double> elapsed_seconds = std::chrono::steady_clock::now() - sps.start_time;
+
+		std::cout << "Wrote " << pattern_database.get_pattern_count() << " distances to " << out_path << " in " << elapsed_seconds.count() << " seconds" << std::endl;
+	}
+	catch (const std::exception &error)
+	{
+		std::cerr << error.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,429 @@
+#include "../json.hpp"
+
+
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+/*
+Writes a random puzzle in the format of puzzles/klotski.jsonc, for measuring how the solver scales with the number of states.
+
+The board is surrounded by walls. The goal piece is the biggest shape of the mix and is placed first,
+after which randomly drawn shapes are put at random free spots until the pieces cover the fill density of the board,
+or until none of the shapes fit anymore.
+The goal piece ends on the bottom row below where it starts, or at the spot opposite of its start through the center of the board,
+and there's no goal at all with "--goal none", which is only of use to --enumerate.
+
+The same arguments always write the same puzzle, as the random numbers come from a seeded std::mt19937_64,
+which is the same everywhere, unlike the distributions of the standard library.
+Nothing checks whether the goal can be reached, so run the puzzle to find out.
+
+Usage: puzzle_generator --out <file> [--width <n>] [--height <n>] [--shapes <mix>] [--density <fraction>] [--goal <goal>] [--seed <n>]
+*/
+
+
+static std::string const piece_labels = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+
+struct Shape
+{
+	int width;
+	int height;
+	int weight;
+};
+
+
+struct PlacedPiece
+{
+	int x;
+	int y;
+	Shape shape;
+};
+
+
+struct GeneratorOptions
+{
+	std::string out_path;
+
+	// The size of the board inside of the walls.
+	int width = 4;
+	int height = 5;
+
+	// Every shape is written like "2x1:3", with its width, height and how likely it is to be drawn compared to the others.
+	std::string shapes = "1x1:4,1x2:2,2x1:1,2x2:1";
+
+	// The fraction of the cells the pieces cover at most.
+	double density = 0.8;
+
+	// "bottom", "opposite" or "none".
+	std::string goal = "bottom";
+
+	uint64_t seed = 0;
+};
+
+
+static std::vector<Shape> get_shapes(const std::string &shapes_string)
+{
+	std::vector<Shape> shapes;
+
+	std::stringstream shapes_stream(shapes_string);
+	std::string shape_string;
+
+	while (std::getline(shapes_stream, shape_string, ','))
+	{
+		Shape shape;
+		char x_character;
+		char colon_character;
+
+		std::stringstream shape_stream(shape_string);
+
+		if (!(shape_stream >> shape.width >> x_character >> shape.height >> colon_character >> shape.weight)
+			|| x_character != 'x' || colon_character != ':' || shape.width < 1 || shape.height < 1 || shape.weight < 0)
+		{
+			throw std::invalid_argument("The shape \"" + shape_string + "\" isn't written like \"2x1:3\"");
+		}
+
+		shapes.push_back(shape);
+	}
+
+	if (shapes.empty())
+	{
+		throw std::invalid_argument("There are no shapes to draw from");
+	}
+
+	return shapes;
+}
+
+
+// Slightly favors small numbers when n isn't a power of two, which doesn't matter here, but makes it the same everywhere.
+static int get_random_int_below(std::mt19937_64 &random, const int n)
+{
+	return random() % n;
+}
+
+
+class PuzzleGenerator
+{
+public:
+	PuzzleGenerator(const GeneratorOptions &options_) : options(options_), random(options_.seed), shapes(get_shapes(options_.shapes)) {};
+
+	void generate(void);
+	void write(void);
+
+	int get_covered_cell_count(void) const;
+
+	std::vector<PlacedPiece> pieces;
+
+private:
+	// Returns false if there's no free spot left for the shape.
+	bool place_randomly(const Shape &shape);
+
+	bool fits(const Shape &shape, const int x, const int y) const;
+	void set_cells(const PlacedPiece &piece, const char label);
+
+	std::string get_board_comment(void) const;
+
+	const GeneratorOptions &options;
+
+	std::mt19937_64 random;
+
+	std::vector<Shape> shapes;
+
+	// Indexed by y and then by x, with ' ' for the free cells.
+	std::vector<std::string> cells;
+
+	int ending_x;
+	int ending_y;
+};
+
+
+void PuzzleGenerator::generate(void)
+{
+	cells.assign(options.height, std::string(options.width, ' '));
+
+	// The biggest shape that can be drawn, whose first occurrence in the mix wins ties.
+	const Shape *goal_shape = nullptr;
+
+	for (const auto &shape : shapes)
+	{
+		if (shape.weight > 0 && (goal_shape == nullptr || shape.width * shape.height > goal_shape->width * goal_shape->height))
+		{
+			goal_shape = &shape;
+		}
+	}
+
+	if (goal_shape == nullptr || goal_shape->width > options.width || goal_shape->height > options.height)
+	{
+		throw std::invalid_argument("The biggest shape doesn't fit on the board");
+	}
+
+	// Starts on the top row, so "bottom" can move it all the way down.
+	const int goal_x = get_random_int_below(random, options.width - goal_shape->width + 1);
+	pieces.push_back({goal_x, 0, *goal_shape});
+	set_cells(pieces.back(), piece_labels[0]);
+
+	ending_x = options.goal == "opposite" ? options.width - goal_shape->width - goal_x : goal_x;
+	ending_y = options.height - goal_shape->height;
+
+	const int max_covered_cell_count = options.density * options.width * options.height;
+
+	std::vector<Shape> drawable_shapes = shapes;
+
+	while (pieces.size() < piece_labels.size() && !drawable_shapes.empty())
+	{
+		int total_weight = 0;
+
+		for (const auto &shape : drawable_shapes)
+		{
+			total_weight += shape.weight;
+		}
+
+		if (total_weight == 0)
+		{
+			break;
+		}
+
+		int drawn_weight = get_random_int_below(random, total_weight);
+		std::size_t shape_index = 0;
+
+		while (drawn_weight >= drawable_shapes[shape_index].weight)
+		{
+			drawn_weight -= drawable_shapes[shape_index].weight;
+			shape_index++;
+		}
+
+		const Shape &shape = drawable_shapes[shape_index];
+
+		// A shape that is too big now stays too big, as the pieces only ever cover more cells.
+		if (get_covered_cell_count() + shape.width * shape.height > max_covered_cell_count || !place_randomly(shape))
+		{
+			drawable_shapes.erase(drawable_shapes.begin() + shape_index);
+		}
+	}
+}
+
+
+int PuzzleGenerator::get_covered_cell_count(void) const
+{
+	int covered_cell_count = 0;
+
+	for (const auto &piece : pieces)
+	{
+		covered_cell_count += piece.shape.width * piece.shape.height;
+	}
+
+	return covered_cell_count;
+}
+
+
+bool PuzzleGenerator::place_randomly(const Shape &shape)
+{
+	std::vector<std::pair<int, int>> free_spots;
+
+	for (int y = 0; y + shape.height <= options.height; ++y)
+	{
+		for (int x = 0; x + shape.width <= options.width; ++x)
+		{
+			if (fits(shape, x, y))
+			{
+				free_spots.push_back({x, y});
+			}
+		}
+	}
+
+	if (free_spots.empty())
+	{
+		return false;
+	}
+
+	const auto [x, y] = free_spots[get_random_int_below(random, free_spots.size())];
+
+	pieces.push_back({x, y, shape});
+	set_cells(pieces.back(), piece_labels[pieces.size() - 1]);
+
+	return true;
+}
+
+
+bool PuzzleGenerator::fits(const Shape &shape, const int x, const int y) const
+{
+	for (int dy = 0; dy < shape.height; ++dy)
+	{
+		for (int dx = 0; dx < shape.width; ++dx)
+		{
+			if (cells[y + dy][x + dx] != ' ')
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+void PuzzleGenerator::set_cells(const PlacedPiece &piece, const char label)
+{
+	for (int dy = 0; dy < piece.shape.height; ++dy)
+	{
+		for (int dx = 0; dx < piece.shape.width; ++dx)
+		{
+			cells[piece.y + dy][piece.x + dx] = label;
+		}
+	}
+}
+
+
+// The board drawn like the comment at the top of puzzles/klotski.jsonc.
+std::string PuzzleGenerator::get_board_comment(void) const
+{
+	const std::string wall_row(options.width + 2, '#');
+
+	std::string board_comment = "\t// " + wall_row + "\n";
+
+	for (const auto &row : cells)
+	{
+		board_comment += "\t// #" + row + "#\n";
+	}
+
+	board_comment += "\t// " + wall_row + "\n";
+
+	return board_comment;
+}
+
+
+void PuzzleGenerator::write(void)
+{
+	nlohmann::ordered_json starting_pieces_info_json = nlohmann::ordered_json::array();
+
+	for (std::size_t piece_index = 0; piece_index < pieces.size(); ++piece_index)
+	{
+		const PlacedPiece &piece = pieces[piece_index];
+
+		// The walls take up the first row and column.
+		nlohmann::ordered_json piece_json = {
+			{"top_left", {{"x", piece.x + 1}, {"y", piece.y + 1}}},
+			{"rects", {{
+				{"offset", {{"x", 0}, {"y", 0}}},
+				{"size", {{"width", piece.shape.width}, {"height", piece.shape.height}}}
+			}}}
+		};
+
+		if (piece_index == 0 && options.goal != "none")
+		{
+			piece_json["end"] = {{"x", ending_x + 1}, {"y", ending_y + 1}};
+		}
+
+		starting_pieces_info_json.push_back(piece_json);
+	}
+
+	const auto get_wall_json = [](const int x, const int y, const int width, const int height)
+	{
+		return nlohmann::ordered_json{
+			{"pos", {{"x", x}, {"y", y}}},
+			{"size", {{"width", width}, {"height", height}}}
+		};
+	};
+
+	const int width = options.width;
+	const int height = options.height;
+
+	const nlohmann::ordered_json puzzle_json = {
+		{"starting_pieces_info", starting_pieces_info_json},
+		{"walls", {
+			get_wall_json(0, 0, width + 2, 1),
+			get_wall_json(0, height + 1, width + 2, 1),
+			get_wall_json(0, 1, 1, height),
+			get_wall_json(width + 1, 1, 1, height)
+		}}
+	};
+
+	std::ofstream stream(options.out_path);
+
+	// The JSON starts with the opening brace, after which the comment goes.
+	const std::string json_string = puzzle_json.dump(1, '\t');
+
+	stream << "{\n";
+	stream << "\t// puzzle_generator --width " << width << " --height " << height << " --shapes " << options.shapes
+		<< " --density " << options.density << " --goal " << options.goal << " --seed " << options.seed << "\n";
+	stream << get_board_comment();
+	stream << json_string.substr(2) << std::endl;
+
+	if (!stream)
+	{
+		throw std::runtime_error("Couldn't write " + options.out_path);
+	}
+}
+
+
+int main(int argc, char *argv[])
+{
+	GeneratorOptions options;
+
+	try
+	{
+		for (int arg_index = 1; arg_index + 1 < argc; arg_index += 2)
+		{
+			const std::string arg = argv[arg_index];
+			const std::string value = argv[arg_index + 1];
+
+			if (arg == "--out")
+			{
+				options.out_path = value;
+			}
+			else if (arg == "--width")
+			{
+				options.width = std::stoi(value);
+			}
+			else if (arg == "--height")
+			{
+				options.height = std::stoi(value);
+			}
+			else if (arg == "--shapes")
+			{
+				options.shapes = value;
+			}
+			else if (arg == "--density")
+			{
+				options.density = std::stod(value);
+			}
+			else if (arg == "--goal")
+			{
+				options.goal = value;
+			}
+			else if (arg == "--seed")
+			{
+				options.seed = std::stoull(value);
+			}
+			else
+			{
+				throw std::invalid_argument("Unknown argument \"" + arg + "\"");
+			}
+		}
+
+		if (options.out_path.empty() || argc % 2 == 0 || options.width < 1 || options.height < 1
+			|| (options.goal != "bottom" && options.goal != "opposite" && options.goal != "none"))
+		{
+			throw std::invalid_argument("Usage: puzzle_generator --out <file> [--width <n>] [--height <n>] [--shapes <mix>] [--density <fraction>] [--goal bottom|opposite|none] [--seed <n>]");
+		}
+
+		PuzzleGenerator puzzle_generator(options);
+
+		puzzle_generator.generate();
+		puzzle_generator.write();
+
+		std::cout << "Wrote " << puzzle_generator.pieces.size() << " pieces covering " << puzzle_generator.get_covered_cell_count()
+			<< " of the " << options.width * options.height << " cells to " << options.out_path << std::endl;
+	}
+	catch (const std::exception &error)
+	{
+		std::cerr << error.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
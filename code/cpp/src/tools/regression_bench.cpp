@@ -0,0 +1,298 @@
+#include "../json.hpp"
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <unistd.h>
+
+
+/*
+Runs puzzle on every run of bench/corpus.jsonc, writes what the --metrics-out summaries say to bench/results.json,
+and fails if a run found a path of another length than in bench/baseline.json, or got slower than the tolerance allows.
+Runs that don't find a path, like --enumerate, fail if they visited another number of states instead.
+
+Every run is repeated, and only the fastest repetition counts, as the slower ones mostly measure what else the machine was doing.
+Runs that took less than min_compared_seconds in the baseline only have their path length compared, as their throughput is mostly noise.
+"--update-baseline" writes the results to bench/baseline.json instead of comparing them, which is needed after a deliberate change,
+or on another machine, as the baseline only holds for the machine it was measured on.
+
+Usage: regression_bench [--runs <n>] [--tolerance <fraction>] [--update-baseline]
+*/
+
+
+using json = nlohmann::ordered_json;
+
+
+static double constexpr min_compared_seconds = 0.5;
+
+
+struct BenchOptions
+{
+	int repetition_count = 3;
+
+	// The fraction the states per second of a run may drop by compared to the baseline.
+	double tolerance = 0.15;
+
+	bool update_baseline = false;
+};
+
+
+static json read_json(const std::filesystem::path &path)
+{
+	std::ifstream stream(path);
+
+	if (!stream)
+	{
+		throw std::runtime_error("Couldn't open " + path.string());
+	}
+
+	return json::parse(
+		stream,
+		nullptr, // callback
+		true, // allow exceptions
+		true // ignore_comments
+	);
+}
+
+
+static void write_json(const std::filesystem::path &path, const json &json_value)
+{
+	std::ofstream stream(path);
+
+	stream << json_value.dump(1, '\t') << std::endl;
+
+	if (!stream)
+	{
+		throw std::runtime_error("Couldn't write " + path.string());
+	}
+}
+
+
+// The summary is always the last line puzzle writes to its --metrics-out file.
+static json read_summary(const std::filesystem::path &metrics_path)
+{
+	std::ifstream stream(metrics_path);
+
+	std::string line;
+	std::string last_line;
+
+	while (std::getline(stream, line))
+	{
+		last_line = line;
+	}
+
+	const json summary = json::parse(last_line, nullptr, false);
+
+	if (summary.is_discarded() || summary["type"] != "summary")
+	{
+		throw std::runtime_error(metrics_path.string() + " doesn't end with a summary");
+	}
+
+	return summary;
+}
+
+
+// Returns the results of the fastest repetition of the run.
+static json get_run_result(const std::filesystem::path &directory_path, const json &run, const int repetition_count)
+{
+	// Named after the process, so benches that run at the same time don't read each other's summaries.
+	const std::filesystem::path metrics_path = std::filesystem::temp_directory_path() / ("regression_bench_" + std::to_string(getpid()) + ".jsonl");
+
+	const std::string command = "\"" + (directory_path / "puzzle").string() + "\" --puzzle " + run["puzzle"].get<std::string>()
+		+ " " + run["args"].get<std::string>() + " --metrics-out \"" + metrics_path.string() + "\" > /dev/null";
+
+	json fastest_summary;
+
+	for (int repetition_index = 0; repetition_index < repetition_count; ++repetition_index)
+	{
+		if (std::system(command.c_str()) != 0)
+		{
+			throw std::runtime_error("This command failed: " + command);
+		}
+
+		const json summary = read_summary(metrics_path);
+
+		if (repetition_index > 0 && summary["path_length"] != fastest_summary["path_length"])
+		{
+			throw std::runtime_error("The run " + run["name"].get<std::string>() + " found paths of different lengths when it was repeated");
+		}
+
+		if (repetition_index == 0 || summary["wall_seconds"] < fastest_summary["wall_seconds"])
+		{
+			fastest_summary = summary;
+		}
+	}
+
+	std::filesystem::remove(metrics_path);
+
+	const double wall_seconds = fastest_summary["wall_seconds"];
+	const uint64_t unique_state_count = fastest_summary["unique_states"];
+
+	return {
+		{"name", run["name"]},
+		{"puzzle", run["puzzle"]},
+		{"args", run["args"]},
+		{"path_length", fastest_summary["path_length"]},
+		{"unique_states", unique_state_count},
+		{"states_per_second", unique_state_count / wall_seconds},
+		{"peak_resident_bytes", fastest_summary["peak_resident_bytes"]},
+		{"wall_seconds", wall_seconds}
+	};
+}
+
+
+static const json *find_baseline_result(const json &baseline, const std::string &name)
+{
+	for (const auto &baseline_result : baseline["runs"])
+	{
+		if (baseline_result["name"] == name)
+		{
+			return &baseline_result;
+		}
+	}
+
+	return nullptr;
+}
+
+
+static std::string get_path_length_string(const json &path_length)
+{
+	return path_length.is_null() ? "-" : std::to_string(path_length.get<int>());
+}
+
+
+// Prints the result next to the baseline, and returns false if it is a regression.
+static bool compare_result(const json &result, const json *baseline_result, const double tolerance)
+{
+	const double states_per_second = result["states_per_second"];
+
+	std::string verdict = "ok";
+	std::string baseline_states_per_second_string = "-";
+	std::string change_string = "-";
+
+	if (baseline_result == nullptr)
+	{
+		verdict = "new";
+	}
+	else
+	{
+		const double baseline_states_per_second = (*baseline_result)["states_per_second"];
+		const double change = states_per_second / baseline_states_per_second - 1;
+
+		baseline_states_per_second_string = std::to_string(std::llround(baseline_states_per_second));
+
+		char change_characters[16];
+		std::snprintf(change_characters, sizeof(change_characters), "%+.1f%%", change * 100);
+		change_string = change_characters;
+
+		if (result["path_length"] != (*baseline_result)["path_length"])
+		{
+			verdict = "FAIL: path length was " + get_path_length_string((*baseline_result)["path_length"]);
+		}
+		// Without a path, like with --enumerate, the number of states is what shows the search still visits the same ones.
+		else if (result["path_length"].is_null() && result["unique_states"] != (*baseline_result)["unique_states"])
+		{
+			verdict = "FAIL: unique states were " + std::to_string((*baseline_result)["unique_states"].get<uint64_t>());
+		}
+		else if ((*baseline_result)["wall_seconds"] < min_compared_seconds)
+		{
+			verdict = "ok (too short to time)";
+		}
+		else if (change < -tolerance)
+		{
+			verdict = "FAIL: slower";
+		}
+	}
+
+	std::printf("%-24s %12lld %12s %8s %10.1f %6s %9.3f  %s\n", result["name"].get<std::string>().c_str(), std::llround(states_per_second),
+		baseline_states_per_second_string.c_str(), change_string.c_str(), result["peak_resident_bytes"].get<double>() / (1 << 20),
+		get_path_length_string(result["path_length"]).c_str(), result["wall_seconds"].get<double>(), verdict.c_str());
+
+	return verdict.rfind("FAIL", 0) != 0;
+}
+
+
+int main(int argc, char *argv[])
+{
+	BenchOptions options;
+
+	try
+	{
+		for (int arg_index = 1; arg_index < argc; ++arg_index)
+		{
+			const std::string arg = argv[arg_index];
+
+			if (arg == "--update-baseline")
+			{
+				options.update_baseline = true;
+			}
+			else if (arg == "--runs" && arg_index + 1 < argc)
+			{
+				options.repetition_count = std::stoi(argv[++arg_index]);
+			}
+			else if (arg == "--tolerance" && arg_index + 1 < argc)
+			{
+				options.tolerance = std::stod(argv[++arg_index]);
+			}
+			else
+			{
+				throw std::invalid_argument("Usage: regression_bench [--runs <n>] [--tolerance <fraction>] [--update-baseline]");
+			}
+		}
+
+		if (options.repetition_count < 1)
+		{
+			throw std::invalid_argument("--runs has to be at least 1");
+		}
+
+		// Like puzzle finds the puzzles, everything is found next to the executable.
+		const std::filesystem::path directory_path = std::filesystem::absolute(argv[0]).lexically_normal().parent_path();
+		const std::filesystem::path bench_path = directory_path / "bench";
+		const std::filesystem::path baseline_path = bench_path / "baseline.json";
+
+		const json corpus = read_json(bench_path / "corpus.jsonc");
+		const json baseline = options.update_baseline || !std::filesystem::exists(baseline_path) ? json{{"runs", json::array()}} : read_json(baseline_path);
+
+		json results = {{"runs", json::array()}};
+		bool passed = true;
+
+		std::printf("%-24s %12s %12s %8s %10s %6s %9s  %s\n", "", "states/s", "baseline", "change", "peak MB", "path", "wall s", "result");
+
+		for (const auto &run : corpus["runs"])
+		{
+			const json result = get_run_result(directory_path, run, options.repetition_count);
+
+			passed &= compare_result(result, find_baseline_result(baseline, result["name"]), options.tolerance);
+
+			results["runs"].push_back(result);
+		}
+
+		write_json(bench_path / "results.json", results);
+
+		if (options.update_baseline)
+		{
+			write_json(baseline_path, results);
+
+			std::cout << std::endl << "Wrote the results to " << baseline_path.string() << std::endl;
+		}
+		else if (!passed)
+		{
+			std::cout << std::endl << "Regressed compared to " << baseline_path.string() << ", with a tolerance of "
+				<< options.tolerance * 100 << "%" << std::endl;
+
+			return EXIT_FAILURE;
+		}
+	}
+	catch (const std::exception &error)
+	{
+		std::cerr << error.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
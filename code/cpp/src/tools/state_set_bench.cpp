@@ -0,0 +1,191 @@
+#include "../state/concurrent_state_set.hpp"
+#include "../state/sharded_state_set.hpp"
+
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/*
+Hammers a states set from many threads that all insert the very same keys, each thread in its own order.
+Every key has to be reported as new by exactly one thread, which is checked after every run,
+and the insert throughput of the lock-free ConcurrentStateSet is compared against the mutex-sharded ShardedStateSet.
+
+The claiming of wider keys only runs in a build with wider keys, like "make re STATE_KEY_WORDS=2 && make state_set_bench".
+
+Usage: state_set_bench [thread count] [unique key count]
+*/
+
+
+static int constexpr run_count = 5;
+
+
+static std::vector<state_key_t> get_unique_keys(const std::size_t unique_key_count)
+{
+	std::vector<state_key_t> keys(unique_key_count);
+
+	// Multiplying by an odd number is a bijection modulo 2^62, and leaving the top bits clear keeps clear of the empty and claimed markers,
+	// which only the first keys are given, so ConcurrentStateSet has to keep them aside.
+	const uint64_t low_62_bits = ~uint64_t(0) >> 2;
+	const std::array<uint64_t, 2> marker_first_words = {~uint64_t(0), ~uint64_t(1)};
+
+	// Wider keys come in pairs that only differ after the first word, so a thread that waits for a claimed slot
+	// can't tell them apart until the claiming thread has written its other words.
+	const std::size_t first_word_divisor = state_key_words > 1 ? 2 : 1;
+
+	for (std::size_t key_index = 0; key_index < unique_key_count; ++key_index)
+	{
+		const std::size_t first_word_index = key_index / first_word_divisor;
+
+		keys[key_index].words[0] = first_word_index < marker_first_words.size() ? marker_first_words[first_word_index]
+			: ((first_word_index + 1) * 0x9e3779b97f4a7c15ULL) & low_62_bits;
+
+		for (std::size_t word_index = 1; word_index < state_key_words; ++word_index)
+		{
+			keys[key_index].words[word_index] = (key_index + 1) * 0xbf58476d1ce4e5b9ULL + word_index;
+		}
+	}
+
+	return keys;
+}
+
+
+static std::vector<std::vector<uint32_t>> get_insertion_orders(const std::size_t thread_count, const std::size_t unique_key_count)
+{
+	std::vector<std::vector<uint32_t>> insertion_orders(thread_count, std::vector<uint32_t>(unique_key_count));
+
+	for (std::size_t thread_index = 0; thread_index < thread_count; ++thread_index)
+	{
+		std::vector<uint32_t> &insertion_order = insertion_orders[thread_index];
+
+		for (std::size_t key_index = 0; key_index < unique_key_count; ++key_index)
+		{
+			insertion_order[key_index] = key_index;
+		}
+
+		std::mt19937_64 random(thread_index);
+		std::shuffle(insertion_order.begin(), insertion_order.end(), random);
+	}
+
+	return insertion_orders;
+}
+
+
+template <typename StateSet>
+static double run(const std::vector<state_key_t> &keys, const std::vector<std::vector<uint32_t>> &insertion_orders)
+{
+	const std::size_t thread_count = insertion_orders.size();
+
+	StateSet states;
+	states.reserve(keys.size());
+
+	std::vector<std::atomic<uint32_t>> new_counts(keys.size());
+
+	std::atomic<std::size_t> ready_thread_count = 0;
+	std::atomic<bool> started = false;
+
+	std::vector<std::thread> threads;
+
+	for (std::size_t thread_index = 0; thread_index < thread_count; ++thread_index)
+	{
+		threads.emplace_back([&, thread_index]()
+		{
+			ready_thread_count++;
+
+			while (!started)
+			{
+			}
+
+			for (const auto key_index : insertion_orders[thread_index])
+			{
+				if (states.insert(keys[key_index]))
+				{
+					new_counts[key_index].fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+		});
+	}
+
+	while (ready_thread_count != thread_count)
+	{
+	}
+
+	const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+	started = true;
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	const std::chrono::duration<double> elapsed_seconds = std::chrono::steady_clock::now() - start_time;
+
+	for (std::size_t key_index = 0; key_index < keys.size(); ++key_index)
+	{
+		if (new_counts[key_index] != 1)
+		{
+			throw std::runtime_error("Key " + std::to_string(key_index) + " was reported as new " + std::to_string(new_counts[key_index]) + " times");
+		}
+	}
+
+	if (states.size() != keys.size())
+	{
+		throw std::runtime_error("The set holds " + std::to_string(states.size()) + " keys instead of " + std::to_string(keys.size()));
+	}
+
+	return elapsed_seconds.count();
+}
+
+
+template <typename StateSet>
+static void benchmark(const std::string &name, const std::vector<state_key_t> &keys, const std::vector<std::vector<uint32_t>> &insertion_orders)
+{
+	std::vector<double> elapsed_seconds;
+
+	for (int run_index = 0; run_index < run_count; ++run_index)
+	{
+		elapsed_seconds.push_back(run<StateSet>(keys, insertion_orders));
+	}
+
+	std::sort(elapsed_seconds.begin(), elapsed_seconds.end());
+
+	const double median_elapsed_seconds = elapsed_seconds[run_count / 2];
+	const double insert_count = static_cast<double>(keys.size()) * insertion_orders.size();
+
+	std::cout << name << ": " << median_elapsed_seconds * 1e3 << " ms median of " << run_count << " runs, "
+		<< insert_count / median_elapsed_seconds / 1e6 << " M inserts/s, "
+		<< median_elapsed_seconds / insert_count * 1e9 << " ns/insert" << std::endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+	const std::size_t thread_count = argc > 1 ? std::stoul(argv[1]) : std::max(2U, std::thread::hardware_concurrency());
+	const std::size_t unique_key_count = argc > 2 ? std::stoul(argv[2]) : 1 << 20;
+
+	std::cout << thread_count << " threads each inserting the same " << unique_key_count << " keys" << std::endl;
+
+	const std::vector<state_key_t> keys = get_unique_keys(unique_key_count);
+	const std::vector<std::vector<uint32_t>> insertion_orders = get_insertion_orders(thread_count, unique_key_count);
+
+	try
+	{
+		benchmark<ConcurrentStateSet>("ConcurrentStateSet", keys, insertion_orders);
+		benchmark<ShardedStateSet>("ShardedStateSet", keys, insertion_orders);
+	}
+	catch (const std::runtime_error &error)
+	{
+		std::cerr << error.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -5,17 +5,32 @@
 #include <queue>
 
 
+#include "state_key.hpp"
+#include "bitboard.hpp"
+
+
 typedef int cell_id;
 typedef int piece_direction;
 
 
 typedef std::vector<std::vector<cell_id>> cells_t;
 
+// Build with "make MOVE_ENGINE=cells" to move pieces around in the cell_id grid instead.
+#ifdef CELLS_MOVE_ENGINE
+typedef cells_t board_t;
+#else
+typedef Bitboard board_t;
+#endif
+
 struct Piece;
 typedef std::vector<Piece> pieces_t;
 
-typedef std::queue<std::pair<pieces_t, cells_t>> pieces_queue_t;
+typedef StateKey state_key_t;
 
-typedef std::vector<std::pair<cell_id, piece_direction>> path_t;
+struct QueuedState;
+typedef std::queue<QueuedState> pieces_queue_t;
+
+struct StateRecord;
+typedef std::vector<StateRecord> state_records_t;
 
-typedef std::queue<path_t> path_queue_t;
+typedef std::vector<std::pair<cell_id, piece_direction>> path_t;